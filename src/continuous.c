@@ -0,0 +1,124 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "mm1_continuous.h"
+
+/*
+ * Program continuous
+ *   simulate the continuous-time M/M/1 queue event by event and compare
+ *   it with theory (without control, lambda < mu) and, optionally, with
+ *   the discrete-time approximation of mm1_sim.c
+ *
+ * Usage:
+ *   continuous [-a lambda] [-m mu] [-T interval] [-l limit] [-H horizon]
+ *              [-d dt] [-r rng] [-s seed]
+ *     -a: arrival rate (default 0.25)
+ *     -m: service rate (default 0.30)
+ *     -T: truncate every interval time units (default: no control)
+ *     -l: truncate queue to limit elements (default 2)
+ *     -H: simulated time (default 10000000)
+ *     -d: also run the discrete-time simulation with time step dt
+ *         (p1 = lambda * dt, p2 = mu * dt, interval T / dt steps)
+ *     -r: random number generator: splitmix (default), xoshiro, philox
+ *     -s: seed (default 1234)
+ *
+ * Output (one line per simulation):
+ *   engine mean zero_percent p99 max drop_rate
+ */
+
+void print_line(const char *engine, double mean, double zero, long p99,
+                long max, double drop_rate) {
+    printf("%-10s %10.4f %10.2f %6li %6li %10.6f\n", engine, mean, zero, p99,
+           max, drop_rate);
+}
+
+int main(int argc, char *argv[]) {
+    struct mm1_ct_params p = {0.25, 0.30, 0, 0, 2};
+    double horizon = 1e7;
+    double dt = 0;
+    enum rng_type rng_type = RNG_SPLITMIX;
+    uint64_t seed = 1234;
+    int opt;
+    while ((opt = getopt(argc, argv, "a:m:T:l:H:d:r:s:")) != -1) {
+        switch (opt) {
+        case 'a':
+            p.arrival_rate = atof(optarg);
+            break;
+        case 'm':
+            p.service_rate = atof(optarg);
+            break;
+        case 'T':
+            p.control = 1;
+            p.interval = atof(optarg);
+            break;
+        case 'l':
+            p.limit = atol(optarg);
+            break;
+        case 'H':
+            horizon = atof(optarg);
+            break;
+        case 'd':
+            dt = atof(optarg);
+            break;
+        case 'r':
+            if (rng_parse_type(optarg, &rng_type) != 0) {
+                fprintf(stderr, "unknown random number generator: %s\n",
+                        optarg);
+                return 1;
+            }
+            break;
+        case 's':
+            seed = strtoull(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr,
+                    "usage: %s [-a lambda] [-m mu] [-T interval] [-l limit] "
+                    "[-H horizon] [-d dt] [-r rng] [-s seed]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    struct mm1_ct_stats *s = malloc(sizeof(struct mm1_ct_stats));
+    struct rng r;
+    rng_init(&r, rng_type, seed, 0);
+    if (s == NULL || mm1_ct_run(&p, horizon, &r, s) != 0) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    printf("# lambda: %.4f mu: %.4f control: %i interval: %.4f limit: %li "
+           "horizon: %.0f events: %li\n", p.arrival_rate, p.service_rate,
+           p.control, p.interval, p.limit, horizon, s->events);
+    printf("# engine         mean     zero %%    p99    max  drop_rate\n");
+    print_line("continuous", mm1_ct_mean_length(s),
+               100.0 * s->hist[0] / s->time, mm1_ct_quantile(s, 0.99),
+               s->max_length, mm1_ct_drop_rate(s));
+
+    double rho = p.arrival_rate / p.service_rate;
+    if (!p.control && rho < 1) {
+        // number in system geometric: P(n) = (1 - rho) rho^n
+        long p99 = (long) ceil(log(0.01) / log(rho)) - 1;
+        print_line("theory", rho / (1 - rho), 100.0 * (1 - rho),
+                   p99 > 0 ? p99 : 0, 0, 0);
+    }
+
+    if (dt > 0) {
+        struct mm1_params d = {p.arrival_rate * dt, p.service_rate * dt,
+                               p.control, lround(p.interval / dt), p.limit};
+        struct mm1_stats *ds = malloc(sizeof(struct mm1_stats));
+        if (ds == NULL) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        rng_init(&r, rng_type, seed, 1);
+        mm1_run_events(&d, (long) (horizon / dt), &r, ds);
+        print_line("discrete", mm1_mean_length(ds),
+                   100.0 * ds->hist[0] / ds->steps, mm1_quantile(ds, 0.99),
+                   ds->max_length, mm1_drop_rate(ds));
+        free(ds);
+    }
+    free(s);
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mm1_continuous.h"
+
+enum event_type {
+    ARRIVAL,
+    DEPARTURE,
+    TRUNCATION
+};
+
+/*
+ * Struct event
+ *
+ * Members:
+ *   time:  time of event
+ *   type:  ARRIVAL, DEPARTURE or TRUNCATION
+ *   busy:  DEPARTURE: number of busy period it belongs to (the event is
+ *          stale if truncation to 0 elements ended that busy period)
+ */
+struct event {
+    double time;
+    enum event_type type;
+    long busy;
+};
+
+/*
+ * Struct event_heap
+ *   4-ary min-heap of events ordered by time: children of node i are
+ *   4i + 1 .. 4i + 4, adjacent in memory, and the heap has half the
+ *   levels of a binary heap
+ */
+struct event_heap {
+    struct event *events;
+    int length;
+    int capacity;
+};
+
+/*
+ * Function heap_push
+ *
+ * Return value:
+ *   0: no error
+ *   1: out of memory
+ */
+static int heap_push(struct event_heap *h, struct event e) {
+    if (h->length == h->capacity) {
+        int capacity = h->capacity > 0 ? 2 * h->capacity : 16;
+        struct event *events =
+            realloc(h->events, capacity * sizeof(struct event));
+        if (events == NULL) {
+            return 1;
+        }
+        h->events = events;
+        h->capacity = capacity;
+    }
+    // sift up
+    int i = h->length++;
+    while (i > 0) {
+        int parent = (i - 1) / 4;
+        if (h->events[parent].time <= e.time) {
+            break;
+        }
+        h->events[i] = h->events[parent];
+        i = parent;
+    }
+    h->events[i] = e;
+    return 0;
+}
+
+/*
+ * Function heap_pop
+ *   remove earliest event (heap must not be empty)
+ */
+static struct event heap_pop(struct event_heap *h) {
+    struct event first = h->events[0];
+    struct event last = h->events[--h->length];
+    // sift down
+    int i = 0;
+    for (;;) {
+        int child = 4 * i + 1;
+        if (child >= h->length) {
+            break;
+        }
+        int end = child + 4 < h->length ? child + 4 : h->length;
+        int min = child;
+        for (int c = child + 1; c < end; c++) {
+            if (h->events[c].time < h->events[min].time) {
+                min = c;
+            }
+        }
+        if (last.time <= h->events[min].time) {
+            break;
+        }
+        h->events[i] = h->events[min];
+        i = min;
+    }
+    h->events[i] = last;
+    return first;
+}
+
+/*
+ * Function exponential
+ *   exponentially distributed time with given rate (infinite if rate <= 0)
+ */
+static double exponential(struct rng *r, double rate) {
+    if (rate <= 0) {
+        return INFINITY;
+    }
+    return -log1p(-rng_uniform(r)) / rate;
+}
+
+int mm1_ct_run(const struct mm1_ct_params *p, double horizon, struct rng *r,
+               struct mm1_ct_stats *s) {
+    struct event_heap h = {NULL, 0, 0};
+    int control = p->control && p->interval > 0;
+    long length = 0;
+    long busy = 0;
+    double now = 0;
+    int status = 0;
+
+    memset(s, 0, sizeof(*s));
+    if (horizon <= 0) {
+        return 0;
+    }
+    struct event arrival = {exponential(r, p->arrival_rate), ARRIVAL, 0};
+    status |= heap_push(&h, arrival);
+    if (control) {
+        struct event truncation = {p->interval, TRUNCATION, 0};
+        status |= heap_push(&h, truncation);
+    }
+    while (status == 0 && h.length > 0 && h.events[0].time <= horizon) {
+        struct event e = heap_pop(&h);
+        if (e.type == DEPARTURE && e.busy != busy) {
+            // busy period ended by truncation
+            continue;
+        }
+        // queue length constant since last event
+        double dt = e.time - now;
+        s->hist[length < MM1_HIST_SIZE - 1 ? length : MM1_HIST_SIZE - 1] +=
+            dt;
+        s->area += length * dt;
+        now = e.time;
+        s->events++;
+
+        switch (e.type) {
+        case ARRIVAL:
+            s->arrivals++;
+            if (++length == 1) {
+                // server was idle: new busy period, service starts
+                busy++;
+                struct event departure = {
+                    now + exponential(r, p->service_rate), DEPARTURE, busy};
+                status |= heap_push(&h, departure);
+            }
+            e.time = now + exponential(r, p->arrival_rate);
+            status |= heap_push(&h, e);
+            break;
+        case DEPARTURE:
+            s->departures++;
+            if (--length > 0) {
+                e.time = now + exponential(r, p->service_rate);
+                status |= heap_push(&h, e);
+            }
+            break;
+        case TRUNCATION:
+            if (length > p->limit) {
+                s->dropped += length - p->limit;
+                length = p->limit;
+                if (length == 0) {
+                    // pending departure becomes stale
+                    busy++;
+                }
+            }
+            e.time = now + p->interval;
+            status |= heap_push(&h, e);
+            break;
+        }
+        if (length > s->max_length) {
+            s->max_length = length;
+        }
+    }
+    if (status == 0) {
+        // no event from last event up to horizon
+        double dt = horizon - now;
+        s->hist[length < MM1_HIST_SIZE - 1 ? length : MM1_HIST_SIZE - 1] +=
+            dt;
+        s->area += length * dt;
+        s->time = horizon;
+    }
+    free(h.events);
+    return status;
+}
+
+double mm1_ct_mean_length(const struct mm1_ct_stats *s) {
+    return s->time > 0 ? s->area / s->time : 0;
+}
+
+long mm1_ct_quantile(const struct mm1_ct_stats *s, double q) {
+    // total of histogram instead of time: same rounding as cumulative
+    double total = 0;
+    for (long l = 0; l < MM1_HIST_SIZE; l++) {
+        total += s->hist[l];
+    }
+    double needed = q * total;
+    double cumulative = 0;
+    for (long l = 0; l < MM1_HIST_SIZE; l++) {
+        cumulative += s->hist[l];
+        if (cumulative >= needed) {
+            return l;
+        }
+    }
+    return MM1_HIST_SIZE - 1;
+}
+
+double mm1_ct_drop_rate(const struct mm1_ct_stats *s) {
+    return s->arrivals > 0 ? (double) s->dropped / s->arrivals : 0;
+}
@@ -0,0 +1,104 @@
+#ifndef MM1_CONTINUOUS_H
+#define MM1_CONTINUOUS_H
+
+#include "mm1_sim.h"
+
+/*
+ * Continuous-time simulation engine for the M/M/1 queue: exponential
+ * interarrival and service times, simulated event by event (cost per
+ * event, not per time slice). The time steps of mm1_sim.c approximate
+ * this process with p1 = arrival_rate * dt and p2 = service_rate * dt.
+ *
+ * Pending events (next arrival, end of service, next truncation) are kept
+ * in a 4-ary heap ordered by time.
+ *
+ * With control: every interval time units the queue is truncated to limit
+ * elements (dropped from head; as service times are memoryless, the
+ * service of the new head continues the pending one).
+ */
+
+/*
+ * Struct mm1_ct_params
+ *
+ * Members:
+ *   arrival_rate: arrivals per time unit (lambda)
+ *   service_rate: departures per time unit while busy (mu)
+ *   control:      1: truncate every interval time units, 0: no control
+ *   interval:     check and truncate queue every interval time units
+ *   limit:        truncate queue to limit elements
+ */
+struct mm1_ct_params {
+    double arrival_rate;
+    double service_rate;
+    int control;
+    double interval;
+    long limit;
+};
+
+/*
+ * Struct mm1_ct_stats
+ *
+ * Members:
+ *   time:        simulated time
+ *   events:      number of events processed
+ *   arrivals:    number of arrivals (including those dropped later)
+ *   departures:  number of departures
+ *   dropped:     number of elements dropped by truncation
+ *   area:        integral of queue length over time
+ *   max_length:  maximum queue length
+ *   hist:        time spent at queue length i (see MM1_HIST_SIZE)
+ */
+struct mm1_ct_stats {
+    double time;
+    long events;
+    long arrivals;
+    long departures;
+    long dropped;
+    double area;
+    long max_length;
+    double hist[MM1_HIST_SIZE];
+};
+
+/*
+ * Function mm1_ct_run
+ *   simulate up to time horizon starting with an empty queue
+ *
+ * Parameters:
+ *   p:       parameters of simulation
+ *   horizon: simulated time
+ *   r:       random number generator
+ *   s:       statistics of simulation (output)
+ *
+ * Return value:
+ *   0: no error
+ *   1: out of memory
+ */
+int mm1_ct_run(const struct mm1_ct_params *p, double horizon, struct rng *r,
+               struct mm1_ct_stats *s);
+
+/*
+ * Function mm1_ct_mean_length
+ *
+ * Return value:
+ *   time-average queue length
+ */
+double mm1_ct_mean_length(const struct mm1_ct_stats *s);
+
+/*
+ * Function mm1_ct_quantile
+ *
+ * Return value:
+ *   smallest queue length l with queue length <= l for at least q of the
+ *   time (at most MM1_HIST_SIZE - 1)
+ */
+long mm1_ct_quantile(const struct mm1_ct_stats *s, double q);
+
+/*
+ * Function mm1_ct_drop_rate
+ *
+ * Return value:
+ *   fraction of arrivals dropped by truncation
+ */
+double mm1_ct_drop_rate(const struct mm1_ct_stats *s);
+
+#endif
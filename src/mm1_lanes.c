@@ -0,0 +1,200 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "mm1_lanes.h"
+
+#if defined(__GNUC__) && (defined(__AVX2__) || defined(__AVX512F__))
+
+// 64-bit lanes per vector register; with AVX2 the queues run in groups
+// of 4 (8 lanes in two registers would not fit the 16 registers)
+#if defined(__AVX512F__)
+#define VECTOR_LANES 8
+#else
+#define VECTOR_LANES 4
+#endif
+
+typedef uint64_t lanes_u __attribute__((vector_size(VECTOR_LANES * 8)));
+typedef int64_t lanes_i __attribute__((vector_size(VECTOR_LANES * 8)));
+
+#define LANES_INLINE static inline __attribute__((always_inline))
+
+// steps buffered before their queue lengths are added to the histograms
+#define HIST_BUFFER 64
+// histogram copies per lane, to avoid waiting for the previous increment
+// of the same bucket (merged at the end)
+#define HIST_COPIES 4
+
+/*
+ * Struct xoshiro_lanes
+ *   state of xoshiro256++ for all lanes, s[k] holds word k of every lane
+ */
+struct xoshiro_lanes {
+    lanes_u s[4];
+};
+
+LANES_INLINE lanes_u rotl_lanes(lanes_u x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// same algorithm as rng_next with RNG_XOSHIRO, in all lanes at once
+LANES_INLINE lanes_u next_lanes(struct xoshiro_lanes *x) {
+    lanes_u *s = x->s;
+    lanes_u result = rotl_lanes(s[0] + s[3], 23) + s[0];
+    lanes_u t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl_lanes(s[3], 45);
+    return result;
+}
+
+/*
+ * Function add_to_hist
+ *   add buffered histogram buckets of m steps, lane by lane, rotating over
+ *   the copies of the histogram of each lane
+ */
+static void add_to_hist(const lanes_i *buffer, int m, int n,
+                        long *(*hist)[HIST_COPIES]) {
+    for (int j = 0; j < n; j++) {
+        long **h = hist[j];
+        int t = 0;
+        for (; t + HIST_COPIES <= m; t += HIST_COPIES) {
+            for (int c = 0; c < HIST_COPIES; c++) {
+                h[c][buffer[t + c][j]]++;
+            }
+        }
+        for (; t < m; t++) {
+            h[0][buffer[t][j]]++;
+        }
+    }
+}
+
+/*
+ * Function run_vector
+ *   mm1_run_lanes for n <= VECTOR_LANES queues, one vector register per
+ *   variable
+ */
+static void run_vector(const struct mm1_params *p, int n, long steps,
+                       uint64_t seed, uint64_t stream,
+                       struct mm1_stats *s) {
+    const lanes_i zero = {0};
+    const lanes_i one = zero + 1;
+    const lanes_i hist_last = zero + (MM1_HIST_SIZE - 1);
+    struct xoshiro_lanes x;
+    lanes_i t1, t2, limit, interval;
+    lanes_i length = zero, sum = zero, max = zero;
+    lanes_i arrivals = zero, departures = zero, dropped = zero;
+    lanes_i buffer[HIST_BUFFER];
+    long *hist[VECTOR_LANES][HIST_COPIES];
+    struct rng r;
+
+    // copy 0 is the histogram in s, further copies zeroed on demand by
+    // calloc (only buckets up to the maximum queue length are touched)
+    long (*copies)[HIST_COPIES - 1][MM1_HIST_SIZE] =
+        calloc(n, sizeof(*copies));
+    if (copies == NULL) {
+        for (int j = 0; j < n; j++) {
+            rng_init(&r, RNG_XOSHIRO, seed, stream + j);
+            mm1_run(&p[j], steps, &r, &s[j]);
+        }
+        return;
+    }
+    for (int j = 0; j < n; j++) {
+        hist[j][0] = s[j].hist;
+        for (int c = 1; c < HIST_COPIES; c++) {
+            hist[j][c] = copies[j][c - 1];
+        }
+    }
+    for (int j = 0; j < VECTOR_LANES; j++) {
+        // unused lanes simulate a copy of queue 0, results not stored
+        int k = j < n ? j : 0;
+        rng_init(&r, RNG_XOSHIRO, seed, stream + k);
+        for (int w = 0; w < 4; w++) {
+            x.s[w][j] = r.s[w];
+        }
+        t1[j] = (int64_t) rng_threshold(p[k].arrival_prob);
+        t2[j] = (int64_t) rng_threshold(p[k].departure_prob);
+        if (p[k].control && p[k].interval > 0) {
+            limit[j] = p[k].limit;
+            interval[j] = p[k].interval;
+        } else {
+            // no control: truncation to INT64_MAX never drops
+            limit[j] = INT64_MAX;
+            interval[j] = 1;
+        }
+    }
+    // steps until next truncation
+    lanes_i countdown = interval;
+
+    for (long i = 0; i < steps; i++) {
+        // arrival trial: low 32 bits, departure trial: high 32 bits
+        lanes_u bits = next_lanes(&x);
+        lanes_i arrival = ((lanes_i) (bits & 0xffffffffULL) < t1) & one;
+        lanes_i departure = ((lanes_i) (bits >> 32) < t2) &
+                            (length + arrival > zero) & one;
+        arrivals += arrival;
+        departures += departure;
+        length += arrival - departure;
+
+        // truncation as masks: excess dropped in lanes at end of interval
+        countdown -= one;
+        lanes_i due = countdown == zero;
+        lanes_i excess = (length - limit) & due & (length > limit);
+        dropped += excess;
+        length -= excess;
+        countdown += interval & due;
+
+        sum += length;
+        max += (length - max) & (length > max);
+        lanes_i below = length < hist_last;
+        int t = (int) (i % HIST_BUFFER);
+        buffer[t] = (length & below) | (hist_last & ~below);
+        if (t == HIST_BUFFER - 1 || i == steps - 1) {
+            add_to_hist(buffer, t + 1, n, hist);
+        }
+    }
+
+    for (int j = 0; j < n; j++) {
+        s[j].steps = steps;
+        s[j].arrivals = arrivals[j];
+        s[j].departures = departures[j];
+        s[j].dropped = dropped[j];
+        s[j].sum_length = (double) sum[j];
+        s[j].max_length = max[j];
+        for (long l = 0; l <= max[j] && l < MM1_HIST_SIZE; l++) {
+            for (int c = 1; c < HIST_COPIES; c++) {
+                s[j].hist[l] += hist[j][c][l];
+            }
+        }
+    }
+    free(copies);
+}
+
+void mm1_run_lanes(const struct mm1_params *p, int n, long steps,
+                   uint64_t seed, uint64_t stream, struct mm1_stats *s) {
+    for (int j = 0; j < n; j++) {
+        memset(&s[j], 0, sizeof(s[j]));
+    }
+    if (steps <= 0) {
+        return;
+    }
+    for (int j = 0; j < n; j += VECTOR_LANES) {
+        int group = n - j < VECTOR_LANES ? n - j : VECTOR_LANES;
+        run_vector(p + j, group, steps, seed, stream + j, s + j);
+    }
+}
+
+#else
+
+void mm1_run_lanes(const struct mm1_params *p, int n, long steps,
+                   uint64_t seed, uint64_t stream, struct mm1_stats *s) {
+    struct rng r;
+    for (int j = 0; j < n; j++) {
+        rng_init(&r, RNG_XOSHIRO, seed, stream + j);
+        mm1_run(&p[j], steps, &r, &s[j]);
+    }
+}
+
+#endif
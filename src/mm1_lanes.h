@@ -0,0 +1,38 @@
+#ifndef MM1_LANES_H
+#define MM1_LANES_H
+
+#include "mm1_sim.h"
+
+/*
+ * Multi-lane simulation: independent queues advance in lockstep, one queue
+ * per 64-bit lane of a vector register (AVX-512: 8 queues, AVX2: 2 groups
+ * of 4 queues; compile with e.g. -march=native). Random numbers,
+ * Bernoulli trials (as masks), queue length updates, truncation and
+ * statistics are computed for all lanes at once; only the histogram is
+ * updated lane by lane.
+ *
+ * Lane j uses stream `stream + j` of RNG_XOSHIRO (no 64-bit multiply
+ * needed, so it vectorizes well) and gives exactly the same statistics as
+ * mm1_run with that stream. Without AVX2 (or without GCC vector
+ * extensions) mm1_run is run lane by lane.
+ */
+
+#define MM1_LANES 8
+
+/*
+ * Function mm1_run_lanes
+ *   simulate n <= MM1_LANES queues, each starting empty
+ *
+ * Parameters:
+ *   p:      parameters of simulation of each queue (n elements; control
+ *           interval may differ between queues)
+ *   n:      number of queues (1 .. MM1_LANES)
+ *   steps:  number of time steps
+ *   seed:   seed of RNG_XOSHIRO
+ *   stream: stream of queue 0, queue j uses stream + j
+ *   s:      statistics of each queue (output, n elements)
+ */
+void mm1_run_lanes(const struct mm1_params *p, int n, long steps,
+                   uint64_t seed, uint64_t stream, struct mm1_stats *s);
+
+#endif
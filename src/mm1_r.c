@@ -0,0 +1,167 @@
+#include <R.h>
+#include <Rinternals.h>
+#include <R_ext/Rdynload.h>
+
+/*
+ * Compiled backend of generate_time_series in mm1_queue.R, called via
+ * .Call - same arguments, same random numbers (R's RNG via rbinom, in the
+ * same order), therefore the same series for the same seed.
+ *
+ * Build (from the directory of mm1_queue.R):
+ *   R CMD SHLIB src/mm1_r.c
+ */
+
+/*
+ * Function mm1_generate_time_series
+ *
+ * Parameters:
+ *   steps:          number of time steps
+ *   arrival_prob:   probability of arrival in a time step
+ *   departure_prob: probability of departure in a time step
+ *   control:        TRUE: truncate every 10 steps to limit elements
+ *   limit:          limit of queue length (Inf: no limit)
+ *
+ * Return value:
+ *   numeric vector of queue lengths after each time step
+ */
+SEXP mm1_generate_time_series(SEXP steps, SEXP arrival_prob,
+                              SEXP departure_prob, SEXP control,
+                              SEXP limit) {
+    R_xlen_t n = (R_xlen_t) asReal(steps);
+    double p1 = asReal(arrival_prob);
+    double p2 = asReal(departure_prob);
+    int ctrl = asLogical(control) == TRUE;
+    double lim = asReal(limit);
+
+    if (n < 0 || ISNAN(p1) || ISNAN(p2) || p1 < 0 || p1 > 1 || p2 < 0 ||
+        p2 > 1) {
+        error("invalid arguments");
+    }
+
+    SEXP result = PROTECT(allocVector(REALSXP, n));
+    double *queue_length = REAL(result);
+    double previous = 0;
+
+    GetRNGstate();
+    for (R_xlen_t i = 0; i < n; i++) {
+        // either zero or one arrivals
+        double arrival = rbinom(1, p1);
+        // either zero or one departures
+        // always zero departures if queue is empty
+        double departure = 0;
+        if (previous + arrival != 0) {
+            departure = rbinom(1, p2);
+        }
+        // queue length after current time step
+        double current = previous + arrival - departure;
+        // if control:
+        // truncate every 10 steps (time steps counted from 1)
+        if (ctrl && (i + 1) % 10 == 0 && current > lim) {
+            current = lim;
+        }
+        queue_length[i] = current;
+        previous = current;
+        if ((i & 0xfffff) == 0) {
+            R_CheckUserInterrupt();
+        }
+    }
+    PutRNGstate();
+
+    UNPROTECT(1);
+    return result;
+}
+
+/*
+ * Function mm1_generate_time_series_events
+ *   same process as mm1_generate_time_series, jumping from event to event:
+ *   the number of steps until the next arrival or departure is geometric
+ *   (rgeom), the steps in between keep the queue length. Same series in
+ *   distribution, not for the same seed; faster for small probabilities.
+ *
+ * Parameters:
+ *   see mm1_generate_time_series
+ *
+ * Return value:
+ *   numeric vector of queue lengths after each time step
+ */
+SEXP mm1_generate_time_series_events(SEXP steps, SEXP arrival_prob,
+                                     SEXP departure_prob, SEXP control,
+                                     SEXP limit) {
+    R_xlen_t n = (R_xlen_t) asReal(steps);
+    double p1 = asReal(arrival_prob);
+    double p2 = asReal(departure_prob);
+    int ctrl = asLogical(control) == TRUE;
+    double lim = asReal(limit);
+
+    if (n < 0 || ISNAN(p1) || ISNAN(p2) || p1 < 0 || p1 > 1 || p2 < 0 ||
+        p2 > 1) {
+        error("invalid arguments");
+    }
+
+    SEXP result = PROTECT(allocVector(REALSXP, n));
+    double *queue_length = REAL(result);
+    // kinds of events in a step with queue length > 0
+    double up = p1 * (1 - p2);
+    double down = (1 - p1) * p2;
+    double both = p1 * p2;
+    // probability of an event in a step: empty queue needs an arrival
+    double event_empty = p1;
+    double event_busy = up + down + both;
+    double previous = 0;
+    R_xlen_t done = 0;
+    long events = 0;
+
+    GetRNGstate();
+    while (done < n) {
+        // time step of next truncation (or end of series)
+        R_xlen_t end = ctrl ? (done / 10 + 1) * 10 : n;
+        if (end > n) {
+            end = n;
+        }
+        double prob = previous > 0 ? event_busy : event_empty;
+        double gap = prob > 0 ? 1 + rgeom(prob) : R_PosInf;
+        // no event up to end: gap is memoryless, drawn again after end
+        int event = gap <= end - done;
+        R_xlen_t stop = event ? done + (R_xlen_t) gap : end;
+        for (R_xlen_t i = done; i < stop - 1; i++) {
+            queue_length[i] = previous;
+        }
+        double current = previous;
+        if (event) {
+            double r = unif_rand() * prob;
+            if (previous == 0) {
+                // arrival, departs in the same step with probability p2
+                current = r < both ? 0 : 1;
+            } else if (r < up) {
+                current = previous + 1;
+            } else if (r < up + down) {
+                current = previous - 1;
+            }
+        }
+        done = stop;
+        if (ctrl && done % 10 == 0 && current > lim) {
+            current = lim;
+        }
+        queue_length[done - 1] = current;
+        previous = current;
+        if ((++events & 0xfffff) == 0) {
+            R_CheckUserInterrupt();
+        }
+    }
+    PutRNGstate();
+
+    UNPROTECT(1);
+    return result;
+}
+
+static const R_CallMethodDef call_methods[] = {
+    {"mm1_generate_time_series", (DL_FUNC) &mm1_generate_time_series, 5},
+    {"mm1_generate_time_series_events",
+     (DL_FUNC) &mm1_generate_time_series_events, 5},
+    {NULL, NULL, 0}
+};
+
+void R_init_mm1_r(DllInfo *dll) {
+    R_registerRoutines(dll, NULL, call_methods, NULL, NULL);
+    R_useDynamicSymbols(dll, FALSE);
+}
@@ -0,0 +1,131 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "mm1_replicate.h"
+
+/*
+ * Struct pool
+ *   shared by all threads of one mm1_replicate call
+ */
+struct pool {
+    const struct mm1_replication *r;
+    struct mm1_summary *summaries;
+    // index of next replication to be run
+    atomic_long next;
+};
+
+/*
+ * Function order_statistic
+ *
+ * Return value:
+ *   queue length at position k (from 0) of all steps sorted by length
+ */
+static long order_statistic(const struct mm1_stats *s, long k) {
+    long cumulative = 0;
+    for (long l = 0; l < MM1_HIST_SIZE; l++) {
+        cumulative += s->hist[l];
+        if (cumulative > k) {
+            return l;
+        }
+    }
+    return MM1_HIST_SIZE - 1;
+}
+
+void mm1_summarize(const struct mm1_stats *s, struct mm1_summary *summary) {
+    long n = s->steps;
+    summary->queue_zero = n > 0 ? 100.0 * s->hist[0] / n : 0;
+    summary->median = n > 0 ? (order_statistic(s, (n - 1) / 2) +
+                               order_statistic(s, n / 2)) / 2.0
+                            : 0;
+    summary->mean = mm1_mean_length(s);
+    summary->max = s->max_length;
+    summary->drop_rate = mm1_drop_rate(s);
+}
+
+/*
+ * Function run_lanes
+ *   replications first .. first + MM1_LANES - 1 (as far as there are)
+ *   with mm1_run_lanes
+ */
+static void run_lanes(struct pool *pool, long first, struct mm1_stats *s) {
+    const struct mm1_replication *r = pool->r;
+    struct mm1_params p[MM1_LANES];
+    int n = r->replications - first < MM1_LANES
+                ? (int) (r->replications - first)
+                : MM1_LANES;
+    for (int j = 0; j < n; j++) {
+        p[j] = r->params;
+    }
+    mm1_run_lanes(p, n, r->steps, r->seed, first, s);
+    for (int j = 0; j < n; j++) {
+        mm1_summarize(&s[j], &pool->summaries[first + j]);
+    }
+}
+
+static void* worker(void *arg) {
+    struct pool *pool = arg;
+    const struct mm1_replication *r = pool->r;
+    // statistics and generator are private to the thread
+    long batch = r->lanes ? MM1_LANES : 1;
+    struct mm1_stats *s = malloc(batch * sizeof(struct mm1_stats));
+    struct rng rng;
+    long i;
+
+    if (s == NULL) {
+        // replications left to the other threads
+        return NULL;
+    }
+    while ((i = atomic_fetch_add(&pool->next, batch)) < r->replications) {
+        // stream depends on replication only, not on thread
+        if (r->lanes) {
+            run_lanes(pool, i, s);
+            continue;
+        }
+        rng_init(&rng, r->rng, r->seed, i);
+        if (r->bits > 0) {
+            mm1_run_sliced(&r->params, r->bits, r->steps, &rng, s);
+        } else if (r->events) {
+            mm1_run_events(&r->params, r->steps, &rng, s);
+        } else {
+            mm1_run(&r->params, r->steps, &rng, s);
+        }
+        mm1_summarize(s, &pool->summaries[i]);
+    }
+    free(s);
+    return NULL;
+}
+
+int mm1_replicate(const struct mm1_replication *r, int threads,
+                  struct mm1_summary *summaries) {
+    struct pool pool;
+    pool.r = r;
+    pool.summaries = summaries;
+    atomic_init(&pool.next, 0);
+
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > r->replications) {
+        threads = r->replications > 0 ? (int) r->replications : 1;
+    }
+    pthread_t *workers = malloc(threads * sizeof(pthread_t));
+    if (workers == NULL) {
+        return 1;
+    }
+    int started = 0;
+    while (started < threads &&
+           pthread_create(&workers[started], NULL, worker, &pool) == 0) {
+        started++;
+    }
+    if (started == 0) {
+        // no thread at all: run in calling thread
+        worker(&pool);
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+    // replications not run if no thread got its statistics
+    return atomic_load(&pool.next) < r->replications;
+}
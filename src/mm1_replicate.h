@@ -0,0 +1,84 @@
+#ifndef MM1_REPLICATE_H
+#define MM1_REPLICATE_H
+
+#include "mm1_lanes.h"
+
+/*
+ * Replication engine: runs independent replications of one simulation on
+ * a pool of threads (as run_stats in mm1_queue.R, which replicates
+ * serially). Replication i uses stream i of the random number generator,
+ * so the summaries are bit-identical for any number of threads.
+ */
+
+/*
+ * Struct mm1_summary
+ *   summary of one replication, same statistics as run_stats in
+ *   mm1_queue.R
+ *
+ * Members:
+ *   queue_zero: percentage of steps with queue length zero
+ *   median:     median of queue length (mean of both middle values if the
+ *               number of steps is even, as median() in R)
+ *   mean:       mean of queue length
+ *   max:        maximum of queue length
+ *   drop_rate:  fraction of arrivals dropped by truncation
+ */
+struct mm1_summary {
+    double queue_zero;
+    double median;
+    double mean;
+    long max;
+    double drop_rate;
+};
+
+/*
+ * Struct mm1_replication
+ *
+ * Members:
+ *   params:       parameters of simulation
+ *   steps:        time steps per replication
+ *   replications: number of replications
+ *   rng:          random number generator
+ *   seed:         seed shared by all replications
+ *   events:       1: event-skipping simulation (mm1_run_events)
+ *   lanes:        1: multi-lane simulation (mm1_run_lanes), MM1_LANES
+ *                 replications at once, always with RNG_XOSHIRO (same
+ *                 results as mm1_run with RNG_XOSHIRO), events ignored
+ *   bits:         > 0: bit-sliced Bernoulli trials with probabilities of
+ *                 bits bits (mm1_run_sliced)
+ */
+struct mm1_replication {
+    struct mm1_params params;
+    long steps;
+    long replications;
+    enum rng_type rng;
+    uint64_t seed;
+    int events;
+    int lanes;
+    int bits;
+};
+
+/*
+ * Function mm1_summarize
+ *   summary of statistics of one simulation run
+ */
+void mm1_summarize(const struct mm1_stats *s, struct mm1_summary *summary);
+
+/*
+ * Function mm1_replicate
+ *   run all replications on threads threads
+ *
+ * Parameters:
+ *   r:         replications to be run
+ *   threads:   number of threads (at least 1)
+ *   summaries: summary of replication i in summaries[i] (output,
+ *              r->replications elements)
+ *
+ * Return value:
+ *   0: no error
+ *   1: out of memory or thread not created
+ */
+int mm1_replicate(const struct mm1_replication *r, int threads,
+                  struct mm1_summary *summaries);
+
+#endif
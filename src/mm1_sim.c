@@ -0,0 +1,259 @@
+#include <math.h>
+#include <string.h>
+
+#include "mm1_sim.h"
+
+// random words per 64 steps up to which mm1_run_sliced is faster than
+// mm1_run (64 words): each word costs a step of the bit-by-bit loop, and
+// the rest of the step costs the same (measured break-even: 14 words)
+#define MM1_SLICED_MAX_WORDS 12
+
+/*
+ * Function step
+ *   one time step, returns queue length after arrival and departure
+ */
+static inline long step(long length, uint64_t t1, uint64_t t2,
+                        struct rng *r, struct mm1_stats *s) {
+    // arrival trial: low 32 bits, departure trial: high 32 bits
+    uint64_t bits = rng_next(r);
+    long arrival = (bits & 0xffffffffULL) < t1;
+    long departure = ((bits >> 32) < t2) & (length + arrival > 0);
+    s->arrivals += arrival;
+    s->departures += departure;
+    return length + arrival - departure;
+}
+
+static inline void record(long length, struct mm1_stats *s) {
+    s->sum_length += length;
+    if (length > s->max_length) {
+        s->max_length = length;
+    }
+    s->hist[length < MM1_HIST_SIZE - 1 ? length : MM1_HIST_SIZE - 1]++;
+}
+
+void mm1_run(const struct mm1_params *p, long steps, struct rng *r,
+             struct mm1_stats *s) {
+    uint64_t t1 = rng_threshold(p->arrival_prob);
+    uint64_t t2 = rng_threshold(p->departure_prob);
+    // control needs a positive interval
+    int control = p->control && p->interval > 0;
+    long interval = control ? p->interval : steps;
+    long length = 0;
+
+    memset(s, 0, sizeof(*s));
+    if (steps <= 0) {
+        return;
+    }
+    s->steps = steps;
+    // chunks of interval steps, truncation after the last step of a chunk
+    for (long done = 0; done < steps; done += interval) {
+        long n = steps - done < interval ? steps - done : interval;
+        for (long i = 0; i < n - 1; i++) {
+            length = step(length, t1, t2, r, s);
+            record(length, s);
+        }
+        length = step(length, t1, t2, r, s);
+        if (control && n == interval && length > p->limit) {
+            s->dropped += length - p->limit;
+            length = p->limit;
+        }
+        record(length, s);
+    }
+}
+
+/*
+ * Function sliced_prob
+ *   probability of trials of rng_bernoulli64
+ */
+static double sliced_prob(const struct rng_bernoulli *b) {
+    return b->always ? 1 : b->p * 0x1.0p-32;
+}
+
+int mm1_sliced_params(const struct mm1_params *p, int bits,
+                      struct mm1_params *simulated) {
+    struct rng_bernoulli arrival_trials, departure_trials;
+    rng_bernoulli_init(&arrival_trials, p->arrival_prob, bits);
+    rng_bernoulli_init(&departure_trials, p->departure_prob, bits);
+    *simulated = *p;
+    if (arrival_trials.words + departure_trials.words >
+        MM1_SLICED_MAX_WORDS) {
+        return 0;
+    }
+    simulated->arrival_prob = sliced_prob(&arrival_trials);
+    simulated->departure_prob = sliced_prob(&departure_trials);
+    return 1;
+}
+
+void mm1_run_sliced(const struct mm1_params *p, int bits, long steps,
+                    struct rng *r, struct mm1_stats *s) {
+    struct rng_bernoulli arrival_trials, departure_trials;
+    // outcomes of the next trials, one bit per step
+    uint64_t arrivals = 0;
+    uint64_t departures = 0;
+    int control = p->control && p->interval > 0;
+    long countdown = p->interval;
+    long length = 0;
+
+    struct mm1_params simulated;
+    if (!mm1_sliced_params(p, bits, &simulated)) {
+        mm1_run(p, steps, r, s);
+        return;
+    }
+    rng_bernoulli_init(&arrival_trials, p->arrival_prob, bits);
+    rng_bernoulli_init(&departure_trials, p->departure_prob, bits);
+    memset(s, 0, sizeof(*s));
+    if (steps <= 0) {
+        return;
+    }
+    s->steps = steps;
+    for (long i = 0; i < steps; i++) {
+        if ((i & 63) == 0) {
+            arrivals = rng_bernoulli64(r, &arrival_trials);
+            departures = rng_bernoulli64(r, &departure_trials);
+        }
+        long arrival = arrivals & 1;
+        long departure = (departures & 1) & (length + arrival > 0);
+        arrivals >>= 1;
+        departures >>= 1;
+        s->arrivals += arrival;
+        s->departures += departure;
+        length += arrival - departure;
+        if (control && --countdown == 0) {
+            countdown = p->interval;
+            if (length > p->limit) {
+                s->dropped += length - p->limit;
+                length = p->limit;
+            }
+        }
+        record(length, s);
+    }
+}
+
+static double clamp_prob(double prob) {
+    return prob < 0 ? 0 : prob > 1 ? 1 : prob;
+}
+
+/*
+ * Function next_gap
+ *   number of steps up to and including the next event, geometric with
+ *   event probability prob per step (log_stay = log(1 - prob))
+ *
+ * Return value:
+ *   gap in 1 .. max + 1 (max + 1: no event within the next max steps)
+ */
+static long next_gap(double prob, double log_stay, long max,
+                     struct rng *r) {
+    if (prob >= 1) {
+        return 1;
+    }
+    if (prob <= 0) {
+        return max + 1;
+    }
+    double gap = 1 + floor(log1p(-rng_uniform(r)) / log_stay);
+    return gap > max ? max + 1 : (long) gap;
+}
+
+/*
+ * Function record_n
+ *   record n steps at the same queue length
+ */
+static inline void record_n(long length, long n, struct mm1_stats *s) {
+    if (n <= 0) {
+        return;
+    }
+    s->sum_length += (double) length * n;
+    if (length > s->max_length) {
+        s->max_length = length;
+    }
+    s->hist[length < MM1_HIST_SIZE - 1 ? length : MM1_HIST_SIZE - 1] += n;
+}
+
+void mm1_run_events(const struct mm1_params *p, long steps, struct rng *r,
+                    struct mm1_stats *s) {
+    double p1 = clamp_prob(p->arrival_prob);
+    double p2 = clamp_prob(p->departure_prob);
+    // kinds of events in a step with queue length > 0
+    double up = p1 * (1 - p2);      // arrival only
+    double down = (1 - p1) * p2;    // departure only
+    double both = p1 * p2;          // arrival and departure, length unchanged
+    // probability of an event in a step: empty queue needs an arrival
+    double event_empty = p1;
+    double event_busy = up + down + both;
+    double log_empty = log1p(-event_empty);
+    double log_busy = log1p(-event_busy);
+    // control needs a positive interval
+    int control = p->control && p->interval > 0;
+    long interval = control ? p->interval : steps;
+    long length = 0;
+    long done = 0;
+
+    memset(s, 0, sizeof(*s));
+    if (steps <= 0) {
+        return;
+    }
+    s->steps = steps;
+    while (done < steps) {
+        // last step of current chunk (truncation, see mm1_run)
+        long end = (done / interval + 1) * interval;
+        if (end > steps) {
+            end = steps;
+        }
+        long gap = length > 0
+                       ? next_gap(event_busy, log_busy, end - done, r)
+                       : next_gap(event_empty, log_empty, end - done, r);
+        if (gap > end - done) {
+            // no event up to end of chunk; the geometric gap is memoryless,
+            // so it is drawn again for the next chunk
+            record_n(length, end - done - 1, s);
+            done = end;
+        } else {
+            record_n(length, gap - 1, s);
+            done += gap;
+            double u = rng_uniform(r) *
+                       (length > 0 ? event_busy : event_empty);
+            if (length == 0) {
+                // arrival, departs in the same step with probability p2
+                s->arrivals++;
+                if (u < both) {
+                    s->departures++;
+                } else {
+                    length++;
+                }
+            } else if (u < up) {
+                s->arrivals++;
+                length++;
+            } else if (u < up + down) {
+                s->departures++;
+                length--;
+            } else {
+                s->arrivals++;
+                s->departures++;
+            }
+        }
+        if (control && done % interval == 0 && length > p->limit) {
+            s->dropped += length - p->limit;
+            length = p->limit;
+        }
+        record(length, s);
+    }
+}
+
+double mm1_drop_rate(const struct mm1_stats *s) {
+    return s->arrivals > 0 ? (double) s->dropped / s->arrivals : 0;
+}
+
+double mm1_mean_length(const struct mm1_stats *s) {
+    return s->steps > 0 ? s->sum_length / s->steps : 0;
+}
+
+long mm1_quantile(const struct mm1_stats *s, double q) {
+    double needed = q * s->steps;
+    long cumulative = 0;
+    for (long l = 0; l < MM1_HIST_SIZE; l++) {
+        cumulative += s->hist[l];
+        if (cumulative >= needed) {
+            return l;
+        }
+    }
+    return MM1_HIST_SIZE - 1;
+}
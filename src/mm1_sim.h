@@ -0,0 +1,162 @@
+#ifndef MM1_SIM_H
+#define MM1_SIM_H
+
+#include <stdint.h>
+
+#include "rng.h"
+
+/*
+ * Simulation engine for the discrete-time M/M/1 queue (see README),
+ * tracking the queue length only.
+ *
+ * In each time step:
+ * - one arrival with probability arrival_prob
+ * - one departure with probability departure_prob, only possible if
+ *   queue length > 0 after arrivals
+ * - with control: every interval steps the queue is truncated to limit
+ *   elements (the truncated length is the length of that step)
+ */
+
+// queue lengths >= MM1_HIST_SIZE - 1 share the last bucket of histogram
+#define MM1_HIST_SIZE 4096
+
+/*
+ * Struct mm1_params
+ *
+ * Members:
+ *   arrival_prob:   probability of arrival in a time step
+ *   departure_prob: probability of departure in a time step
+ *   control:        1: truncate every interval steps, 0: no control
+ *   interval:       check and truncate queue every interval steps
+ *   limit:          truncate queue to limit elements
+ */
+struct mm1_params {
+    double arrival_prob;
+    double departure_prob;
+    int control;
+    long interval;
+    long limit;
+};
+
+/*
+ * Struct mm1_stats
+ *
+ * Members:
+ *   steps:       number of time steps
+ *   arrivals:    number of arrivals (including those dropped later)
+ *   departures:  number of departures
+ *   dropped:     number of elements dropped by truncation
+ *   sum_length:  sum of queue lengths over all steps
+ *   max_length:  maximum queue length
+ *   hist:        number of steps with queue length i (see MM1_HIST_SIZE)
+ */
+struct mm1_stats {
+    long steps;
+    long arrivals;
+    long departures;
+    long dropped;
+    double sum_length;
+    long max_length;
+    long hist[MM1_HIST_SIZE];
+};
+
+/*
+ * Function mm1_run
+ *   simulate steps time steps starting with an empty queue
+ *
+ * Parameters:
+ *   p:      parameters of simulation
+ *   steps:  number of time steps
+ *   r:      random number generator, e.g. one stream per replication
+ *           (same stream, same result)
+ *   s:      statistics of simulation (output)
+ */
+void mm1_run(const struct mm1_params *p, long steps, struct rng *r,
+             struct mm1_stats *s);
+
+/*
+ * Function mm1_run_sliced
+ *   same simulation as mm1_run, with the Bernoulli trials of 64 steps
+ *   generated at once by rng_bernoulli64: probabilities with a short
+ *   binary expansion (0.5, 0.25) need one or two random words per 64
+ *   steps instead of 64. Probabilities are rounded to multiples of
+ *   2^-bits, results equal those of mm1_run in distribution for exactly
+ *   representable probabilities. If the trials need more than 12 random
+ *   words per 64 steps (e.g. 0.30 with 32 bits: 32 words), the bit-sliced
+ *   loop is no faster and mm1_run is used instead (probabilities not
+ *   rounded). End to end the saving is smaller than for the random
+ *   numbers alone, as recording the queue length costs the same: about
+ *   15-20% for 0.25 and 0.5.
+ *
+ * Parameters:
+ *   p:      parameters of simulation
+ *   bits:   precision of probabilities (1 .. 32)
+ *   steps:  number of time steps
+ *   r:      random number generator
+ *   s:      statistics of simulation (output)
+ */
+void mm1_run_sliced(const struct mm1_params *p, int bits, long steps,
+                    struct rng *r, struct mm1_stats *s);
+
+/*
+ * Function mm1_sliced_params
+ *   parameters actually simulated by mm1_run_sliced
+ *
+ * Parameters:
+ *   p:         parameters passed to mm1_run_sliced
+ *   bits:      precision passed to mm1_run_sliced
+ *   simulated: p with probabilities rounded to bits bits if bit-sliced,
+ *              else p unchanged (output)
+ *
+ * Return value:
+ *   1: bit-sliced simulation
+ *   0: mm1_run is used instead (not faster for these probabilities)
+ */
+int mm1_sliced_params(const struct mm1_params *p, int bits,
+                      struct mm1_params *simulated);
+
+/*
+ * Function mm1_run_events
+ *   same simulation as mm1_run, jumping from event to event: the number of
+ *   steps until the next arrival or departure is drawn from a geometric
+ *   distribution and the steps in between are recorded in bulk. Runtime
+ *   scales with the number of events instead of the number of steps, so
+ *   this is faster for small arrival and departure probabilities. Results
+ *   equal those of mm1_run in distribution, not for the same stream.
+ *
+ * Parameters:
+ *   see mm1_run
+ */
+void mm1_run_events(const struct mm1_params *p, long steps, struct rng *r,
+                    struct mm1_stats *s);
+
+/*
+ * Function mm1_drop_rate
+ *
+ * Return value:
+ *   fraction of arrivals dropped by truncation
+ */
+double mm1_drop_rate(const struct mm1_stats *s);
+
+/*
+ * Function mm1_mean_length
+ *
+ * Return value:
+ *   mean queue length over all steps
+ */
+double mm1_mean_length(const struct mm1_stats *s);
+
+/*
+ * Function mm1_quantile
+ *
+ * Parameters:
+ *   s:      statistics of simulation
+ *   q:      quantile (e.g. 0.99)
+ *
+ * Return value:
+ *   smallest queue length l with at least q of all steps at length <= l
+ *   (at most MM1_HIST_SIZE - 1)
+ */
+long mm1_quantile(const struct mm1_stats *s, double q);
+
+#endif
@@ -0,0 +1,438 @@
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mmc_sim.h"
+
+// end of a list of servers
+#define NONE (-1)
+// due step of an idle server
+#define IDLE (-1)
+// due step of a service that never completes (departure_prob 0)
+#define NEVER LONG_MAX
+
+/*
+ * Struct wheel
+ *   timing wheel of service completions: busy server i completes at step
+ *   due[i] and is kept in the list of slot due[i] & mask (doubly linked
+ *   through next/prev, so a service can be cancelled in O(1)); slots hold
+ *   completions of later rounds too, which are skipped when scanned
+ */
+struct wheel {
+    int *head;
+    int *next;
+    int *prev;
+    long *due;
+    long mask;
+};
+
+/*
+ * Struct buckets
+ *   servers by queue length: list head[l] holds all servers with queue
+ *   length l, min and max are the shortest and longest queue
+ */
+struct buckets {
+    int *head;
+    int *next;
+    int *prev;
+    long capacity;
+    long min;
+    long max;
+};
+
+/*
+ * Struct mmc
+ *   state of simulation
+ *
+ * Members:
+ *   length:   queue length per server, including element in service
+ *             (MMC_SHARED: 1 busy, 0 idle)
+ *   waiting:  MMC_SHARED: elements waiting in shared queue
+ *   pool:     MMC_SHARED: pool[0 .. idle - 1] idle servers, rest busy
+ *   pos:      MMC_SHARED: position of server in pool
+ *   total:    number of elements in system
+ */
+struct mmc {
+    const struct mmc_params *p;
+    struct rng *r;
+    int c;
+    double log_stay;
+    long *length;
+    long waiting;
+    int *pool;
+    int *pos;
+    int idle;
+    long total;
+    struct wheel w;
+    struct buckets b;
+};
+
+static void list_insert(int *head, int *next, int *prev, int i) {
+    next[i] = *head;
+    prev[i] = NONE;
+    if (*head != NONE) {
+        prev[*head] = i;
+    }
+    *head = i;
+}
+
+static void list_remove(int *head, int *next, int *prev, int i) {
+    if (prev[i] != NONE) {
+        next[prev[i]] = next[i];
+    } else {
+        *head = next[i];
+    }
+    if (next[i] != NONE) {
+        prev[next[i]] = prev[i];
+    }
+}
+
+/*
+ * Function start_service
+ *   server starts serving an element in step start, completion scheduled
+ *   after a geometric number of steps (completion in step start itself
+ *   with probability departure_prob)
+ */
+static void start_service(struct mmc *m, int server, long start) {
+    struct wheel *w = &m->w;
+    double prob = m->p->departure_prob;
+    double steps = prob >= 1 ? 1
+                 : prob <= 0 ? INFINITY
+                 : 1 + floor(log1p(-rng_uniform(m->r)) / m->log_stay);
+    if (steps >= (double) (NEVER - start)) {
+        w->due[server] = NEVER;
+        return;
+    }
+    w->due[server] = start + (long) steps - 1;
+    list_insert(&w->head[w->due[server] & w->mask], w->next, w->prev,
+                server);
+}
+
+static void cancel_service(struct mmc *m, int server) {
+    struct wheel *w = &m->w;
+    if (w->due[server] != IDLE && w->due[server] != NEVER) {
+        list_remove(&w->head[w->due[server] & w->mask], w->next, w->prev,
+                    server);
+    }
+    w->due[server] = IDLE;
+}
+
+/*
+ * Function set_length
+ *   move server to bucket of new queue length
+ *
+ * Return value:
+ *   0: no error
+ *   1: out of memory
+ */
+static int set_length(struct mmc *m, int server, long length) {
+    struct buckets *b = &m->b;
+    long old = m->length[server];
+    if (length >= b->capacity) {
+        long capacity = 2 * b->capacity;
+        while (length >= capacity) {
+            capacity *= 2;
+        }
+        int *head = realloc(b->head, capacity * sizeof(int));
+        if (head == NULL) {
+            return 1;
+        }
+        for (long l = b->capacity; l < capacity; l++) {
+            head[l] = NONE;
+        }
+        b->head = head;
+        b->capacity = capacity;
+    }
+    list_remove(&b->head[old], b->next, b->prev, server);
+    list_insert(&b->head[length], b->next, b->prev, server);
+    m->length[server] = length;
+    // lengths change by one except for truncation, which only lowers max
+    // (amortized by the arrivals that raised it)
+    if (length > b->max) {
+        b->max = length;
+    }
+    if (length < b->min) {
+        b->min = length;
+    }
+    while (b->head[b->max] == NONE) {
+        b->max--;
+    }
+    while (b->head[b->min] == NONE) {
+        b->min++;
+    }
+    return 0;
+}
+
+static int arrive(struct mmc *m, long now) {
+    m->total++;
+    if (m->p->dispatch == MMC_SHARED) {
+        if (m->idle == 0) {
+            m->waiting++;
+            return 0;
+        }
+        int server = m->pool[--m->idle];
+        m->length[server] = 1;
+        start_service(m, server, now);
+        return 0;
+    }
+    int server;
+    if (m->p->dispatch == MMC_JSQ) {
+        server = m->b.head[m->b.min];
+    } else {
+        // two servers at random (multiply-shift, no modulo)
+        uint64_t bits = rng_next(m->r);
+        int a = (int) (((bits & 0xffffffffULL) * m->c) >> 32);
+        int b = (int) (((bits >> 32) * m->c) >> 32);
+        server = m->length[b] < m->length[a] ? b : a;
+    }
+    if (set_length(m, server, m->length[server] + 1) != 0) {
+        return 1;
+    }
+    if (m->length[server] == 1) {
+        start_service(m, server, now);
+    }
+    return 0;
+}
+
+static int complete(struct mmc *m, int server, long now) {
+    m->total--;
+    m->w.due[server] = IDLE;
+    if (m->p->dispatch == MMC_SHARED) {
+        if (m->waiting > 0) {
+            // next element of shared queue, served from next step on
+            m->waiting--;
+            start_service(m, server, now + 1);
+            return 0;
+        }
+        m->length[server] = 0;
+        // swap server to end of idle part of pool
+        int other = m->pool[m->idle];
+        m->pool[m->pos[server]] = other;
+        m->pos[other] = m->pos[server];
+        m->pool[m->idle] = server;
+        m->pos[server] = m->idle++;
+        return 0;
+    }
+    if (set_length(m, server, m->length[server] - 1) != 0) {
+        return 1;
+    }
+    if (m->length[server] > 0) {
+        start_service(m, server, now + 1);
+    }
+    return 0;
+}
+
+/*
+ * Function truncate_queues
+ *
+ * Return value:
+ *   number of dropped elements
+ */
+static long truncate_queues(struct mmc *m) {
+    long limit = m->p->limit < 0 ? 0 : m->p->limit;
+    long dropped = 0;
+    if (m->p->dispatch == MMC_SHARED) {
+        if (m->total <= limit) {
+            return 0;
+        }
+        // memoryless service: waiting elements dropped first, then
+        // elements in service
+        long excess = m->total - limit;
+        long from_waiting = excess < m->waiting ? excess : m->waiting;
+        m->waiting -= from_waiting;
+        for (long i = from_waiting; i < excess; i++) {
+            int server = m->pool[m->idle];
+            cancel_service(m, server);
+            m->length[server] = 0;
+            m->idle++;
+        }
+        m->total = limit;
+        return excess;
+    }
+    while (m->b.max > limit) {
+        int server = m->b.head[m->b.max];
+        dropped += m->length[server] - limit;
+        set_length(m, server, limit);
+        if (limit == 0) {
+            cancel_service(m, server);
+        }
+    }
+    m->total -= dropped;
+    return dropped;
+}
+
+/*
+ * Function record
+ *   record queue length of a step, histogram grown by doubling
+ *
+ * Return value:
+ *   0: no error
+ *   1: out of memory
+ */
+static int record(long length, struct mmc_stats *s) {
+    if (length >= s->hist_size) {
+        long size = s->hist_size > 0 ? 2 * s->hist_size : MM1_HIST_SIZE;
+        while (length >= size) {
+            size *= 2;
+        }
+        long *hist = realloc(s->hist, size * sizeof(long));
+        if (hist == NULL) {
+            return 1;
+        }
+        memset(hist + s->hist_size, 0,
+               (size - s->hist_size) * sizeof(long));
+        s->hist = hist;
+        s->hist_size = size;
+    }
+    s->sum_length += length;
+    if (length > s->max_length) {
+        s->max_length = length;
+    }
+    s->hist[length]++;
+    return 0;
+}
+
+static void free_mmc(struct mmc *m) {
+    free(m->length);
+    free(m->pool);
+    free(m->pos);
+    free(m->w.head);
+    free(m->w.next);
+    free(m->w.prev);
+    free(m->w.due);
+    free(m->b.head);
+    free(m->b.next);
+    free(m->b.prev);
+}
+
+int mmc_run(const struct mmc_params *p, long steps, struct rng *r,
+            struct mmc_stats *s) {
+    struct mmc m;
+    int c = p->servers;
+    uint64_t t1 = rng_threshold(p->arrival_prob);
+    int control = p->control && p->interval > 0;
+    int status = 0;
+
+    // keep histogram of previous run
+    long *hist = s->hist;
+    long hist_size = s->hist_size;
+    memset(s, 0, sizeof(*s));
+    if (hist_size > 0) {
+        memset(hist, 0, hist_size * sizeof(long));
+    }
+    s->hist = hist;
+    s->hist_size = hist_size;
+    if (c < 1) {
+        return 1;
+    }
+    // wheel covers about four mean service times
+    long slots = 64;
+    while (p->departure_prob > 0 && slots < (1L << 20) &&
+           slots * p->departure_prob < 4) {
+        slots *= 2;
+    }
+    memset(&m, 0, sizeof(m));
+    m.p = p;
+    m.r = r;
+    m.c = c;
+    m.log_stay = log1p(-p->departure_prob);
+    m.length = calloc(c, sizeof(long));
+    m.pool = malloc(c * sizeof(int));
+    m.pos = malloc(c * sizeof(int));
+    m.w.head = malloc(slots * sizeof(int));
+    m.w.next = malloc(c * sizeof(int));
+    m.w.prev = malloc(c * sizeof(int));
+    m.w.due = malloc(c * sizeof(long));
+    m.w.mask = slots - 1;
+    m.b.capacity = 64;
+    m.b.head = malloc(m.b.capacity * sizeof(int));
+    m.b.next = malloc(c * sizeof(int));
+    m.b.prev = malloc(c * sizeof(int));
+    if (!m.length || !m.pool || !m.pos || !m.w.head || !m.w.next ||
+        !m.w.prev || !m.w.due || !m.b.head || !m.b.next || !m.b.prev) {
+        free_mmc(&m);
+        return 1;
+    }
+    for (long i = 0; i < slots; i++) {
+        m.w.head[i] = NONE;
+    }
+    for (long l = 0; l < m.b.capacity; l++) {
+        m.b.head[l] = NONE;
+    }
+    // all servers idle, all queues empty
+    for (int i = c - 1; i >= 0; i--) {
+        m.pool[i] = i;
+        m.pos[i] = i;
+        m.w.due[i] = IDLE;
+        list_insert(&m.b.head[0], m.b.next, m.b.prev, i);
+    }
+    m.idle = c;
+
+    if (steps > 0) {
+        s->steps = steps;
+    }
+    for (long now = 0; now < steps && status == 0; now++) {
+        // arrival first, then completions (as in mm1_sim.c)
+        if ((rng_next(r) & 0xffffffffULL) < t1) {
+            s->arrivals++;
+            status |= arrive(&m, now);
+        }
+        int server = m.w.head[now & m.w.mask];
+        while (server != NONE) {
+            // servers rescheduled into this slot are inserted at its head,
+            // behind the scan
+            int next = m.w.next[server];
+            if (m.w.due[server] == now) {
+                list_remove(&m.w.head[now & m.w.mask], m.w.next, m.w.prev,
+                            server);
+                s->departures++;
+                status |= complete(&m, server, now);
+            }
+            server = next;
+        }
+        if (control && (now + 1) % p->interval == 0) {
+            s->dropped += truncate_queues(&m);
+        }
+        status |= record(m.total, s);
+    }
+    free_mmc(&m);
+    return status;
+}
+
+const char* mmc_dispatch_name(enum mmc_dispatch dispatch) {
+    switch (dispatch) {
+    case MMC_JSQ:
+        return "jsq";
+    case MMC_POWER_OF_TWO:
+        return "p2c";
+    default:
+        return "shared";
+    }
+}
+
+void mmc_free_stats(struct mmc_stats *s) {
+    free(s->hist);
+    s->hist = NULL;
+    s->hist_size = 0;
+}
+
+double mmc_drop_rate(const struct mmc_stats *s) {
+    return s->arrivals > 0 ? (double) s->dropped / s->arrivals : 0;
+}
+
+double mmc_mean_length(const struct mmc_stats *s) {
+    return s->steps > 0 ? s->sum_length / s->steps : 0;
+}
+
+long mmc_quantile(const struct mmc_stats *s, double q) {
+    double needed = q * s->steps;
+    long cumulative = 0;
+    for (long l = 0; l <= s->max_length && l < s->hist_size; l++) {
+        cumulative += s->hist[l];
+        if (cumulative >= needed) {
+            return l;
+        }
+    }
+    return s->max_length;
+}
@@ -0,0 +1,143 @@
+#ifndef MMC_SIM_H
+#define MMC_SIM_H
+
+#include "mm1_sim.h"
+
+/*
+ * Simulation engine for the discrete-time queue with c parallel servers
+ * (M/M/c and server pools), tracking queue lengths only.
+ *
+ * In each time step:
+ * - one arrival with probability arrival_prob, dispatched to a server
+ * - each busy server completes its element with probability
+ *   departure_prob, possibly the element that arrived in the same step
+ *   (with c = 1 this is the process of mm1_sim.h)
+ * - with control: every interval steps each queue is truncated to limit
+ *   elements, counting elements in service
+ *
+ * Dispatch:
+ * - MMC_SHARED:       one FIFO queue feeding all servers
+ * - MMC_JSQ:          a queue per server, arrival joins the shortest queue
+ * - MMC_POWER_OF_TWO: a queue per server, arrival joins the shorter of two
+ *                     servers chosen at random
+ *
+ * Cost per step is O(1) amortized, independent of c: service times are
+ * drawn once per element (geometric) and service completions kept in a
+ * timing wheel, servers are kept in buckets by queue length (shortest
+ * and longest queue found in O(1)).
+ */
+
+enum mmc_dispatch {
+    MMC_SHARED,
+    MMC_JSQ,
+    MMC_POWER_OF_TWO
+};
+
+/*
+ * Struct mmc_params
+ *
+ * Members:
+ *   arrival_prob:   probability of arrival in a time step
+ *   departure_prob: probability of completion in a time step, per server
+ *   servers:        number of servers (c)
+ *   dispatch:       MMC_SHARED, MMC_JSQ or MMC_POWER_OF_TWO
+ *   control:        1: truncate every interval steps, 0: no control
+ *   interval:       check and truncate queues every interval steps
+ *   limit:          truncate each queue to limit elements
+ */
+struct mmc_params {
+    double arrival_prob;
+    double departure_prob;
+    int servers;
+    enum mmc_dispatch dispatch;
+    int control;
+    long interval;
+    long limit;
+};
+
+/*
+ * Struct mmc_stats
+ *   as struct mm1_stats, queue length = number of elements in the system
+ *   (all queues, including in service); the histogram grows with the
+ *   maximum length instead of sharing a last bucket, as a pool of many
+ *   servers holds far more than MM1_HIST_SIZE elements
+ *
+ * Members:
+ *   steps:       number of time steps
+ *   arrivals:    number of arrivals (including those dropped later)
+ *   departures:  number of departures
+ *   dropped:     number of elements dropped by truncation
+ *   sum_length:  sum of queue lengths over all steps
+ *   max_length:  maximum queue length
+ *   hist:        number of steps with queue length i, 0 <= i < hist_size
+ *   hist_size:   allocated size of hist (> max_length)
+ */
+struct mmc_stats {
+    long steps;
+    long arrivals;
+    long departures;
+    long dropped;
+    double sum_length;
+    long max_length;
+    long *hist;
+    long hist_size;
+};
+
+/*
+ * Function mmc_run
+ *   simulate steps time steps starting with empty queues
+ *
+ * Parameters:
+ *   p:      parameters of simulation
+ *   steps:  number of time steps
+ *   r:      random number generator
+ *   s:      statistics of simulation (output), zero-initialized or of a
+ *           previous run (histogram reused), freed with mmc_free_stats
+ *
+ * Return value:
+ *   0: no error
+ *   1: out of memory or no server
+ */
+int mmc_run(const struct mmc_params *p, long steps, struct rng *r,
+            struct mmc_stats *s);
+
+/*
+ * Function mmc_free_stats
+ *   free histogram of statistics (s can be reused by mmc_run)
+ */
+void mmc_free_stats(struct mmc_stats *s);
+
+/*
+ * Function mmc_drop_rate
+ *
+ * Return value:
+ *   fraction of arrivals dropped by truncation
+ */
+double mmc_drop_rate(const struct mmc_stats *s);
+
+/*
+ * Function mmc_mean_length
+ *
+ * Return value:
+ *   mean number of elements in the system over all steps
+ */
+double mmc_mean_length(const struct mmc_stats *s);
+
+/*
+ * Function mmc_quantile
+ *
+ * Return value:
+ *   smallest queue length l with queue length <= l in at least q of all
+ *   steps
+ */
+long mmc_quantile(const struct mmc_stats *s, double q);
+
+/*
+ * Function mmc_dispatch_name
+ *
+ * Return value:
+ *   name of dispatch ("shared", "jsq", "p2c")
+ */
+const char* mmc_dispatch_name(enum mmc_dispatch dispatch);
+
+#endif
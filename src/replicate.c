@@ -0,0 +1,199 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "mm1_replicate.h"
+
+/*
+ * Program replicate
+ *   run independent replications of one simulation on all cores and
+ *   report the distribution of the per-replication statistics of
+ *   run_stats in mm1_queue.R (queue zero %, median, mean, max)
+ *
+ * Usage:
+ *   replicate [-n steps] [-m replications] [-p p1] [-q p2] [-l limit]
+ *             [-i interval] [-t threads] [-r rng] [-s seed] [-e] [-v]
+ *             [-b bits] [-a]
+ *     -n: time steps per replication (default 10000)
+ *     -m: number of replications (default 100)
+ *     -p: arrival probability (default 0.25)
+ *     -q: departure probability (default 0.30)
+ *     -l: truncate queue to limit elements (default: no control)
+ *     -i: control interval (default 10)
+ *     -t: number of threads (default: number of cores)
+ *     -r: random number generator: splitmix (default), xoshiro, philox
+ *     -s: seed (default 1234)
+ *     -e: event-skipping simulation (mm1_run_events)
+ *     -v: multi-lane (vector) simulation (mm1_run_lanes), implies -r xoshiro
+ *     -b: bit-sliced Bernoulli trials, probabilities rounded to bits bits
+ *         (mm1_run_sliced, falls back to mm1_run where not faster)
+ *     -a: also report the statistics of each replication
+ *
+ * Output:
+ *   statistic mean min q25 median q75 max
+ *   (with -a first: replication queue_zero median mean max drop_rate)
+ */
+
+/*
+ * Function quantile
+ *   quantile of sorted values, linear interpolation (type 7 in R)
+ */
+double quantile(const double *sorted, long n, double q) {
+    double h = (n - 1) * q;
+    long lo = (long) floor(h);
+    long hi = lo + 1 < n ? lo + 1 : lo;
+    return sorted[lo] + (h - lo) * (sorted[hi] - sorted[lo]);
+}
+
+int compare_doubles(const void *x, const void *y) {
+    double a = *(const double *) x;
+    double b = *(const double *) y;
+    return (a > b) - (a < b);
+}
+
+/*
+ * Function print_distribution
+ *   distribution of one statistic over all replications
+ */
+void print_distribution(const char *name, double *values, long n) {
+    double sum = 0;
+    for (long i = 0; i < n; i++) {
+        sum += values[i];
+    }
+    qsort(values, n, sizeof(double), compare_doubles);
+    printf("%-10s %10.4f %10.4f %10.4f %10.4f %10.4f %10.4f\n", name,
+           sum / n, values[0], quantile(values, n, 0.25),
+           quantile(values, n, 0.5), quantile(values, n, 0.75),
+           values[n - 1]);
+}
+
+int main(int argc, char *argv[]) {
+    struct mm1_replication r = {{0.25, 0.30, 0, 10, 0}, 10000, 100,
+                                RNG_SPLITMIX, 1234, 0, 0, 0};
+    int threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    int all = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:m:p:q:l:i:t:r:s:evb:a")) != -1) {
+        switch (opt) {
+        case 'n':
+            r.steps = atol(optarg);
+            break;
+        case 'm':
+            r.replications = atol(optarg);
+            break;
+        case 'p':
+            r.params.arrival_prob = atof(optarg);
+            break;
+        case 'q':
+            r.params.departure_prob = atof(optarg);
+            break;
+        case 'l':
+            r.params.control = 1;
+            r.params.limit = atol(optarg);
+            break;
+        case 'i':
+            r.params.interval = atol(optarg);
+            break;
+        case 't':
+            threads = atoi(optarg);
+            break;
+        case 'r':
+            if (rng_parse_type(optarg, &r.rng) != 0) {
+                fprintf(stderr, "unknown random number generator: %s\n",
+                        optarg);
+                return 1;
+            }
+            break;
+        case 's':
+            r.seed = strtoull(optarg, NULL, 0);
+            break;
+        case 'e':
+            r.events = 1;
+            break;
+        case 'v':
+            r.lanes = 1;
+            break;
+        case 'b':
+            r.bits = atoi(optarg);
+            break;
+        case 'a':
+            all = 1;
+            break;
+        default:
+            fprintf(stderr,
+                    "usage: %s [-n steps] [-m replications] [-p p1] "
+                    "[-q p2] [-l limit] [-i interval] [-t threads] "
+                    "[-r rng] [-s seed] [-e] [-v] [-b bits] [-a]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (r.lanes) {
+        r.rng = RNG_XOSHIRO;
+    }
+    if (r.replications < 1 || r.steps < 1) {
+        fprintf(stderr, "need at least one replication and one step\n");
+        return 1;
+    }
+
+    long m = r.replications;
+    struct mm1_summary *summaries = calloc(m, sizeof(struct mm1_summary));
+    double *values = malloc(m * sizeof(double));
+    if (summaries == NULL || values == NULL ||
+        mm1_replicate(&r, threads, summaries) != 0) {
+        fprintf(stderr, "replications failed\n");
+        return 1;
+    }
+
+    printf("# replications: %li steps: %li threads: %i rng: %s\n", m,
+           r.steps, threads, rng_type_name(r.rng));
+    printf("# p1: %.4f p2: %.4f control: %i interval: %li limit: %li\n",
+           r.params.arrival_prob, r.params.departure_prob, r.params.control,
+           r.params.interval, r.params.limit);
+    if (r.bits > 0 && !r.lanes) {
+        // probabilities actually simulated
+        struct mm1_params simulated;
+        if (mm1_sliced_params(&r.params, r.bits, &simulated)) {
+            printf("# bits: %i bit-sliced p1: %.10g p2: %.10g\n", r.bits,
+                   simulated.arrival_prob, simulated.departure_prob);
+        } else {
+            printf("# bits: %i not bit-sliced (no faster), p1 and p2 not "
+                   "rounded\n", r.bits);
+        }
+    }
+    if (all) {
+        printf("# replication queue_zero median mean max drop_rate\n");
+        for (long i = 0; i < m; i++) {
+            printf("%li %.1f %.1f %.6f %li %.6f\n", i,
+                   summaries[i].queue_zero, summaries[i].median,
+                   summaries[i].mean, summaries[i].max,
+                   summaries[i].drop_rate);
+        }
+    }
+    printf("# statistic       mean        min        q25     median"
+           "        q75        max\n");
+    for (long i = 0; i < m; i++) {
+        values[i] = summaries[i].queue_zero;
+    }
+    print_distribution("queue_zero", values, m);
+    for (long i = 0; i < m; i++) {
+        values[i] = summaries[i].median;
+    }
+    print_distribution("median", values, m);
+    for (long i = 0; i < m; i++) {
+        values[i] = summaries[i].mean;
+    }
+    print_distribution("mean", values, m);
+    for (long i = 0; i < m; i++) {
+        values[i] = (double) summaries[i].max;
+    }
+    print_distribution("max", values, m);
+    for (long i = 0; i < m; i++) {
+        values[i] = summaries[i].drop_rate;
+    }
+    print_distribution("drop_rate", values, m);
+    free(values);
+    free(summaries);
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <string.h>
+
+#include "rng.h"
+
+void rng_init(struct rng *r, enum rng_type type, uint64_t seed,
+              uint64_t stream) {
+    memset(r, 0, sizeof(*r));
+    r->type = type;
+    switch (type) {
+    case RNG_XOSHIRO: {
+        // hash of (seed, stream) seeds SplitMix64, which fills the state
+        uint64_t h = stream;
+        uint64_t state = seed ^ rng_splitmix(&h);
+        for (int i = 0; i < 4; i++) {
+            r->s[i] = rng_splitmix(&state);
+        }
+        break;
+    }
+    case RNG_PHILOX:
+        r->s[0] = seed;
+        r->s[1] = stream;
+        r->s[2] = 0;
+        break;
+    default:
+        r->type = RNG_SPLITMIX;
+        r->s[0] = seed + stream * 0xd1342543de82ef95ULL;
+        break;
+    }
+}
+
+static inline void mulhilo(uint32_t a, uint32_t b, uint32_t *hi,
+                           uint32_t *lo) {
+    uint64_t product = (uint64_t) a * b;
+    *hi = (uint32_t) (product >> 32);
+    *lo = (uint32_t) product;
+}
+
+uint64_t rng_philox_block(struct rng *r) {
+    // counter: (block, stream), key: seed
+    uint32_t c[4] = {(uint32_t) r->s[2], (uint32_t) (r->s[2] >> 32),
+                     (uint32_t) r->s[1], (uint32_t) (r->s[1] >> 32)};
+    uint32_t k[2] = {(uint32_t) r->s[0], (uint32_t) (r->s[0] >> 32)};
+    for (int round = 0; round < 10; round++) {
+        uint32_t hi0, lo0, hi1, lo1;
+        mulhilo(0xd2511f53, c[0], &hi0, &lo0);
+        mulhilo(0xcd9e8d57, c[2], &hi1, &lo1);
+        c[0] = hi1 ^ c[1] ^ k[0];
+        c[1] = lo1;
+        c[2] = hi0 ^ c[3] ^ k[1];
+        c[3] = lo0;
+        k[0] += 0x9e3779b9;
+        k[1] += 0xbb67ae85;
+    }
+    r->s[2]++;
+    r->buffer = ((uint64_t) c[3] << 32) | c[2];
+    r->buffered = 1;
+    return ((uint64_t) c[1] << 32) | c[0];
+}
+
+void rng_bernoulli_init(struct rng_bernoulli *b, double prob, int bits) {
+    if (bits < 1) {
+        bits = 1;
+    }
+    if (bits > 32) {
+        bits = 32;
+    }
+    double scaled = prob * (double) ((uint64_t) 1 << bits) + 0.5;
+    uint64_t fixed = scaled <= 0 ? 0 : (uint64_t) scaled;
+    b->always = fixed >= (uint64_t) 1 << bits;
+    b->p = b->always ? 0 : (uint32_t) (fixed << (32 - bits));
+    // bits of p from the first (0.5) up to the last one bit
+    b->words = 0;
+    for (uint32_t rest = b->p; rest != 0; rest <<= 1) {
+        b->words++;
+    }
+}
+
+const char* rng_type_name(enum rng_type type) {
+    switch (type) {
+    case RNG_XOSHIRO:
+        return "xoshiro";
+    case RNG_PHILOX:
+        return "philox";
+    default:
+        return "splitmix";
+    }
+}
+
+int rng_parse_type(const char *name, enum rng_type *type) {
+    const enum rng_type types[] = {RNG_SPLITMIX, RNG_XOSHIRO, RNG_PHILOX};
+    for (int i = 0; i < 3; i++) {
+        if (strcmp(name, rng_type_name(types[i])) == 0) {
+            *type = types[i];
+            return 0;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,203 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+/*
+ * Random number generators for the simulation engine, each with
+ * independent, reproducible streams: the stream of a replication (or
+ * thread) is selected by its index, so results do not depend on which
+ * thread runs which replication.
+ *
+ * - RNG_SPLITMIX: SplitMix64, stream i starts at seed + i * 0xd1342543de82ef95
+ * - RNG_XOSHIRO:  xoshiro256++, state of stream i seeded by SplitMix64 from
+ *                 a hash of (seed, i); period 2^256 - 1, so streams
+ *                 overlap with negligible probability
+ * - RNG_PHILOX:   Philox4x32-10, counter-based: key = seed, counter =
+ *                 (i, block), so streams are disjoint by construction and
+ *                 any block can be computed directly
+ *
+ * Bernoulli trials compare 32 random bits with an integer threshold (see
+ * rng_threshold): no division, no modulo bias, any probability with a
+ * resolution of 2^-32 (not only integer percent as with rand() % 100).
+ */
+
+enum rng_type {
+    RNG_SPLITMIX,
+    RNG_XOSHIRO,
+    RNG_PHILOX
+};
+
+/*
+ * Struct rng
+ *
+ * Members:
+ *   type:    generator
+ *   s:       state (SplitMix64: s[0], xoshiro256++: s[0..3],
+ *            Philox: s[0] = key, s[1] = stream, s[2] = next block)
+ *   buffer:  Philox: second 64-bit word of current block
+ *   buffered: Philox: 1 if buffer holds an unused word
+ */
+struct rng {
+    enum rng_type type;
+    uint64_t s[4];
+    uint64_t buffer;
+    int buffered;
+};
+
+/*
+ * Function rng_init
+ *
+ * Parameters:
+ *   r:      generator to be initialized
+ *   type:   RNG_SPLITMIX, RNG_XOSHIRO or RNG_PHILOX
+ *   seed:   seed shared by all streams of an experiment
+ *   stream: index of stream (e.g. replication or grid point)
+ */
+void rng_init(struct rng *r, enum rng_type type, uint64_t seed,
+              uint64_t stream);
+
+/*
+ * Function rng_philox_block
+ *   Philox4x32-10 block number r->s[2] of stream r->s[1]: returns the
+ *   first 64-bit word, keeps the second in r->buffer
+ */
+uint64_t rng_philox_block(struct rng *r);
+
+/*
+ * Function rng_type_name
+ *
+ * Return value:
+ *   name of generator ("splitmix", "xoshiro", "philox")
+ */
+const char* rng_type_name(enum rng_type type);
+
+/*
+ * Function rng_parse_type
+ *
+ * Return value:
+ *   0: no error, *type set
+ *   1: unknown name
+ */
+int rng_parse_type(const char *name, enum rng_type *type);
+
+static inline uint64_t rng_splitmix(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rng_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/*
+ * Function rng_next
+ *
+ * Return value:
+ *   64 random bits
+ */
+static inline uint64_t rng_next(struct rng *r) {
+    switch (r->type) {
+    case RNG_XOSHIRO: {
+        uint64_t *s = r->s;
+        uint64_t result = rng_rotl(s[0] + s[3], 23) + s[0];
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rng_rotl(s[3], 45);
+        return result;
+    }
+    case RNG_PHILOX:
+        if (r->buffered) {
+            r->buffered = 0;
+            return r->buffer;
+        }
+        return rng_philox_block(r);
+    default:
+        return rng_splitmix(&r->s[0]);
+    }
+}
+
+/*
+ * Function rng_threshold
+ *   threshold of Bernoulli trial with probability prob: the trial succeeds
+ *   if 32 random bits < threshold (threshold 2^32: always)
+ */
+static inline uint64_t rng_threshold(double prob) {
+    if (prob <= 0) {
+        return 0;
+    }
+    if (prob >= 1) {
+        return (uint64_t) 1 << 32;
+    }
+    return (uint64_t) (prob * 4294967296.0);
+}
+
+/*
+ * Struct rng_bernoulli
+ *   bit-sliced Bernoulli trials: 64 trials at once, compared bit by bit
+ *   (see rng_bernoulli64)
+ *
+ * Members:
+ *   p:      probability as 32-bit binary fraction
+ *   words:  random words needed for 64 trials (bits of p up to its last
+ *           one bit, e.g. 0.5: 1, 0.25: 2)
+ *   always: 1 if probability is 1
+ */
+struct rng_bernoulli {
+    uint32_t p;
+    int words;
+    int always;
+};
+
+/*
+ * Function rng_bernoulli_init
+ *
+ * Parameters:
+ *   b:      trials to be initialized
+ *   prob:   probability of success
+ *   bits:   precision: prob rounded to nearest multiple of 2^-bits
+ *           (1 .. 32); probabilities with a short binary expansion are
+ *           exact with few bits and need few random words
+ */
+void rng_bernoulli_init(struct rng_bernoulli *b, double prob, int bits);
+
+/*
+ * Function rng_bernoulli64
+ *   64 Bernoulli trials: bit i of the result is 1 if trial i succeeded
+ *
+ * Each trial compares a uniform binary fraction with p, the bits of all 64
+ * fractions coming from one random word per bit of p. Processed from the
+ * last one bit of p upwards, a bit where p has a one makes the trial
+ * succeed if the random bit is 0 and a bit where p has a zero makes it
+ * fail if the random bit is 1 - otherwise the lower bits decide.
+ */
+static inline uint64_t rng_bernoulli64(struct rng *r,
+                                       const struct rng_bernoulli *b) {
+    if (b->always) {
+        return ~(uint64_t) 0;
+    }
+    uint64_t result = 0;
+    for (int i = 32 - b->words; i < 32; i++) {
+        uint64_t u = rng_next(r);
+        result = (b->p >> i) & 1 ? result | ~u : result & ~u;
+    }
+    return result;
+}
+
+/*
+ * Function rng_uniform
+ *
+ * Return value:
+ *   random number in [0, 1) with 53 random bits
+ */
+static inline double rng_uniform(struct rng *r) {
+    return (rng_next(r) >> 11) * 0x1.0p-53;
+}
+
+#endif
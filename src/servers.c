@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mmc_sim.h"
+
+/*
+ * Program servers
+ *   size a pool of servers (e.g. uplink workers) fed by one stream of
+ *   arrivals: simulate 1 .. c servers with each dispatch and report queue
+ *   length and drop rate
+ *
+ * Usage:
+ *   servers [-n steps] [-c servers] [-p p1] [-q p2] [-l limit]
+ *           [-i interval] [-d dispatch] [-r rng] [-s seed]
+ *     -n: time steps per simulation run (default 1000000)
+ *     -c: maximum number of servers (default 8)
+ *     -p: arrival probability (default 0.9)
+ *     -q: departure probability per server (default 0.3)
+ *     -l: truncate each queue to limit elements (default: no control)
+ *     -i: control interval (default 10)
+ *     -d: dispatch: shared, jsq, p2c (default: all)
+ *     -r: random number generator: splitmix (default), xoshiro, philox
+ *     -s: seed (default 1234)
+ *
+ * Output (one line per number of servers and dispatch):
+ *   servers dispatch load mean p99 max drop_rate
+ *   (load: arrival_prob / (servers * departure_prob), stable below 1)
+ */
+
+int parse_dispatch(const char *name, enum mmc_dispatch *dispatch) {
+    const enum mmc_dispatch all[] = {MMC_SHARED, MMC_JSQ, MMC_POWER_OF_TWO};
+    for (int i = 0; i < 3; i++) {
+        if (strcmp(name, mmc_dispatch_name(all[i])) == 0) {
+            *dispatch = all[i];
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    struct mmc_params p = {0.9, 0.3, 1, MMC_SHARED, 0, 10, 0};
+    long steps = 1000000;
+    int max_servers = 8;
+    int all = 1;
+    enum rng_type rng_type = RNG_SPLITMIX;
+    uint64_t seed = 1234;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:c:p:q:l:i:d:r:s:")) != -1) {
+        switch (opt) {
+        case 'n':
+            steps = atol(optarg);
+            break;
+        case 'c':
+            max_servers = atoi(optarg);
+            break;
+        case 'p':
+            p.arrival_prob = atof(optarg);
+            break;
+        case 'q':
+            p.departure_prob = atof(optarg);
+            break;
+        case 'l':
+            p.control = 1;
+            p.limit = atol(optarg);
+            break;
+        case 'i':
+            p.interval = atol(optarg);
+            break;
+        case 'd':
+            if (parse_dispatch(optarg, &p.dispatch) != 0) {
+                fprintf(stderr, "unknown dispatch: %s\n", optarg);
+                return 1;
+            }
+            all = 0;
+            break;
+        case 'r':
+            if (rng_parse_type(optarg, &rng_type) != 0) {
+                fprintf(stderr, "unknown random number generator: %s\n",
+                        optarg);
+                return 1;
+            }
+            break;
+        case 's':
+            seed = strtoull(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr,
+                    "usage: %s [-n steps] [-c servers] [-p p1] [-q p2] "
+                    "[-l limit] [-i interval] [-d dispatch] [-r rng] "
+                    "[-s seed]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    struct mmc_stats s = {0};
+    struct rng r;
+    printf("# steps: %li p1: %.4f p2: %.4f control: %i interval: %li "
+           "limit: %li rng: %s\n", steps, p.arrival_prob, p.departure_prob,
+           p.control, p.interval, p.limit, rng_type_name(rng_type));
+    printf("# servers dispatch load mean p99 max drop_rate\n");
+    enum mmc_dispatch first = all ? MMC_SHARED : p.dispatch;
+    enum mmc_dispatch last = all ? MMC_POWER_OF_TWO : p.dispatch;
+    for (int c = 1; c <= max_servers; c++) {
+        for (enum mmc_dispatch d = first; d <= last; d++) {
+            p.servers = c;
+            p.dispatch = d;
+            // same stream for each dispatch (p2c draws extra numbers)
+            rng_init(&r, rng_type, seed, c);
+            if (mmc_run(&p, steps, &r, &s) != 0) {
+                fprintf(stderr, "simulation failed\n");
+                mmc_free_stats(&s);
+                return 1;
+            }
+            printf("%i %s %.4f %.4f %li %li %.6f\n", c, mmc_dispatch_name(d),
+                   p.arrival_prob / (c * p.departure_prob),
+                   mmc_mean_length(&s), mmc_quantile(&s, 0.99),
+                   s.max_length, mmc_drop_rate(&s));
+        }
+    }
+    mmc_free_stats(&s);
+    return 0;
+}
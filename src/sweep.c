@@ -0,0 +1,236 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "mm1_lanes.h"
+
+/*
+ * Program sweep
+ *   run the controlled simulation over a grid of
+ *   QUEUE_CONTROL_INTERVAL x QUEUE_CONTROL_LIMIT x (p1, p2)
+ *   on all cores and report, for each (p1, p2), the Pareto front of
+ *   drop rate versus mean and 99th percentile of queue length
+ *
+ * Usage:
+ *   sweep [-n steps] [-t threads] [-a] [-e] [-r rng] [-v]
+ *     -n: time steps per simulation run (default 1000000)
+ *     -t: number of threads (default: number of cores)
+ *     -a: report all grid points, not only the Pareto front
+ *     -e: event-skipping simulation (mm1_run_events), faster for small
+ *         probabilities
+ *     -r: random number generator: splitmix (default), xoshiro, philox;
+ *         grid point i uses stream i
+ *     -v: multi-lane (vector) simulation, MM1_LANES grid points at once
+ *         (mm1_run_lanes), always with xoshiro (other -r: warning), not
+ *         combined with -e
+ *
+ * Output (one line per grid point):
+ *   p1 p2 interval limit drop_rate mean p99 pareto
+ */
+
+// (p1, p2) of examples in mm1_example.c, mm1_queue.ino and mm1_queue.R
+const double SCENARIOS[][2] = {
+    {0.50, 0.50}, {0.20, 0.40}, {0.40, 0.20}, {0.49, 0.52},
+    {0.25, 0.30}, {0.30, 0.30}, {0.35, 0.30}
+};
+const int NUM_SCENARIOS = sizeof(SCENARIOS) / sizeof(SCENARIOS[0]);
+// QUEUE_CONTROL_INTERVAL: 1, 2, ..., MAX_INTERVAL
+const int MAX_INTERVAL = 40;
+// QUEUE_CONTROL_LIMIT: 0, 1, ..., MAX_LIMIT
+const int MAX_LIMIT = 35;
+
+/*
+ * Struct point
+ *   grid point and results of its simulation run
+ */
+struct point {
+    struct mm1_params params;
+    double drop_rate;
+    double mean;
+    long p99;
+    int pareto;
+};
+
+struct point *points;
+int num_points;
+long steps = 1000000;
+// simulation used for each grid point: mm1_run or mm1_run_events
+void (*run)(const struct mm1_params *, long, struct rng *,
+            struct mm1_stats *) =
+    mm1_run;
+enum rng_type rng_type = RNG_SPLITMIX;
+int lanes = 0;
+// index of next grid point to be simulated, shared by all threads
+atomic_int next_point;
+
+void store_results(struct point *pt, const struct mm1_stats *s) {
+    pt->drop_rate = mm1_drop_rate(s);
+    pt->mean = mm1_mean_length(s);
+    pt->p99 = mm1_quantile(s, 0.99);
+}
+
+void* worker(void *arg) {
+    (void) arg;
+    int batch = lanes ? MM1_LANES : 1;
+    struct mm1_stats *s = malloc(batch * sizeof(struct mm1_stats));
+    struct mm1_params p[MM1_LANES];
+    struct rng r;
+    int i;
+    while ((i = atomic_fetch_add(&next_point, batch)) < num_points) {
+        // stream depends on grid point only, not on thread
+        if (lanes) {
+            int n = num_points - i < batch ? num_points - i : batch;
+            for (int j = 0; j < n; j++) {
+                p[j] = points[i + j].params;
+            }
+            mm1_run_lanes(p, n, steps, 1234, i, s);
+            for (int j = 0; j < n; j++) {
+                store_results(&points[i + j], &s[j]);
+            }
+            continue;
+        }
+        rng_init(&r, rng_type, 1234, i);
+        run(&points[i].params, steps, &r, s);
+        store_results(&points[i], s);
+    }
+    free(s);
+    return NULL;
+}
+
+/*
+ * Function dominates
+ *   a dominates b if a is no worse in drop rate, mean and p99 and better
+ *   in at least one of them
+ */
+int dominates(const struct point *a, const struct point *b) {
+    int no_worse = a->drop_rate <= b->drop_rate && a->mean <= b->mean &&
+                   a->p99 <= b->p99;
+    int better = a->drop_rate < b->drop_rate || a->mean < b->mean ||
+                 a->p99 < b->p99;
+    return no_worse && better;
+}
+
+int compare_points(const void *x, const void *y) {
+    const struct point *a = x;
+    const struct point *b = y;
+    if (a->drop_rate != b->drop_rate) {
+        return a->drop_rate < b->drop_rate ? -1 : 1;
+    }
+    if (a->mean != b->mean) {
+        return a->mean < b->mean ? -1 : 1;
+    }
+    return (a->p99 > b->p99) - (a->p99 < b->p99);
+}
+
+int main(int argc, char *argv[]) {
+    int threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    int all = 0;
+    // -r given explicitly
+    int rng_given = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:t:aer:v")) != -1) {
+        switch (opt) {
+        case 'n':
+            steps = atol(optarg);
+            break;
+        case 't':
+            threads = atoi(optarg);
+            break;
+        case 'a':
+            all = 1;
+            break;
+        case 'e':
+            run = mm1_run_events;
+            break;
+        case 'r':
+            if (rng_parse_type(optarg, &rng_type) != 0) {
+                fprintf(stderr, "unknown random number generator: %s\n",
+                        optarg);
+                return 1;
+            }
+            rng_given = 1;
+            break;
+        case 'v':
+            lanes = 1;
+            break;
+        default:
+            fprintf(stderr,
+                    "usage: %s [-n steps] [-t threads] [-a] [-e] "
+                    "[-r rng] [-v]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (lanes && run == mm1_run_events) {
+        fprintf(stderr, "-e and -v cannot be combined\n");
+        return 1;
+    }
+    if (lanes && rng_given && rng_type != RNG_XOSHIRO) {
+        fprintf(stderr, "warning: -v uses xoshiro instead of %s\n",
+                rng_type_name(rng_type));
+    }
+    if (lanes) {
+        rng_type = RNG_XOSHIRO;
+    }
+
+    // grid, grouped by scenario
+    int per_scenario = MAX_INTERVAL * (MAX_LIMIT + 1);
+    num_points = NUM_SCENARIOS * per_scenario;
+    points = calloc(num_points, sizeof(struct point));
+    int n = 0;
+    for (int k = 0; k < NUM_SCENARIOS; k++) {
+        for (int interval = 1; interval <= MAX_INTERVAL; interval++) {
+            for (int limit = 0; limit <= MAX_LIMIT; limit++) {
+                struct mm1_params params = {SCENARIOS[k][0], SCENARIOS[k][1],
+                                            1, interval, limit};
+                points[n++].params = params;
+            }
+        }
+    }
+
+    pthread_t *workers = malloc(threads * sizeof(pthread_t));
+    atomic_init(&next_point, 0);
+    for (int i = 0; i < threads; i++) {
+        pthread_create(&workers[i], NULL, worker, NULL);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    free(workers);
+
+    // Pareto front within each scenario
+    for (int k = 0; k < NUM_SCENARIOS; k++) {
+        struct point *group = points + k * per_scenario;
+        for (int i = 0; i < per_scenario; i++) {
+            group[i].pareto = 1;
+            for (int j = 0; j < per_scenario; j++) {
+                if (dominates(&group[j], &group[i])) {
+                    group[i].pareto = 0;
+                    break;
+                }
+            }
+        }
+        qsort(group, per_scenario, sizeof(struct point), compare_points);
+    }
+
+    printf("# grid points: %i steps: %li threads: %i rng: %s%s\n",
+           num_points, steps, threads, rng_type_name(rng_type),
+           lanes ? " (forced by -v)" : "");
+    printf("# p1 p2 interval limit drop_rate mean p99 pareto\n");
+    for (int i = 0; i < num_points; i++) {
+        struct point *pt = &points[i];
+        if (all || pt->pareto) {
+            printf("%.2f %.2f %li %li %.6f %.4f %li %i\n",
+                   pt->params.arrival_prob, pt->params.departure_prob,
+                   pt->params.interval, pt->params.limit, pt->drop_rate,
+                   pt->mean, pt->p99, pt->pareto);
+        }
+    }
+    free(points);
+    return 0;
+}
@@ -0,0 +1,134 @@
+#ifndef FIFO_HPP
+#define FIFO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <utility>
+
+/*
+ * Class template Fifo
+ *   FIFO queue storing values of type T inline in a ring of Capacity
+ *   slots (header-only, C++17)
+ *
+ * Same head/tail algorithm as the power-of-two ring in ring_example.c:
+ * head and tail are monotonically increasing positions, masked to get
+ * slot indices. Capacity is a compile-time constant, so the mask is
+ * folded into the generated code.
+ *
+ * Template parameters:
+ *   T:        type of elements, may be move-only
+ *   Capacity: number of slots, must be a power of two
+ */
+template <typename T, std::size_t Capacity>
+class Fifo {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+    static_assert(Capacity <= (std::size_t(1) << 31),
+                  "Capacity too large for 32-bit positions");
+
+public:
+    using pos = std::uint32_t;
+
+    Fifo() = default;
+    Fifo(const Fifo &) = delete;
+    Fifo &operator=(const Fifo &) = delete;
+
+    ~Fifo() {
+        while (head_ != tail_) {
+            slot(head_++)->~T();
+        }
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    /*
+     * Function length
+     *
+     * Return value:
+     *   number of elements in queue (queue length)
+     */
+    pos length() const { return tail_ - head_; }
+
+    bool empty() const { return head_ == tail_; }
+    bool full() const { return tail_ - head_ == Capacity; }
+
+    /*
+     * Function emplace
+     *   construct new element in place at tail of queue
+     *
+     * Parameters:
+     *   args: arguments forwarded to constructor of T
+     *
+     * Return value:
+     *   0: no error
+     *   1: overflow (all slots occupied, nothing constructed)
+     */
+    template <typename... Args>
+    int emplace(Args &&...args) {
+        if (full()) {
+            return 1;
+        }
+        ::new (static_cast<void *>(slot(tail_))) T(
+            std::forward<Args>(args)...);
+        tail_++;
+        return 0;
+    }
+
+    /*
+     * Function enqueue
+     *   copy or move arrival to tail of queue
+     *
+     * Return value:
+     *   0: no error
+     *   1: overflow (all slots occupied, arrival not enqueued)
+     */
+    int enqueue(const T &arrival) { return emplace(arrival); }
+    int enqueue(T &&arrival) { return emplace(std::move(arrival)); }
+
+    /*
+     * Function front
+     *   element at head of queue, read in place (queue must not be empty)
+     */
+    T &front() { return *slot(head_); }
+    const T &front() const { return *slot(head_); }
+
+    /*
+     * Function dequeue
+     *   remove element at head of queue, FIFO
+     *
+     * Return value:
+     *   dequeued element (moved out of slot)
+     *   std::nullopt if queue was empty
+     */
+    std::optional<T> dequeue() {
+        if (empty()) {
+            return std::nullopt;
+        }
+        T *element = slot(head_);
+        std::optional<T> departure(std::move(*element));
+        element->~T();
+        head_++;
+        return departure;
+    }
+
+private:
+    static constexpr pos mask = static_cast<pos>(Capacity - 1);
+
+    T *slot(pos position) {
+        return std::launder(
+            reinterpret_cast<T *>(storage_[position & mask]));
+    }
+    const T *slot(pos position) const {
+        return std::launder(
+            reinterpret_cast<const T *>(storage_[position & mask]));
+    }
+
+    // uninitialized slots, elements constructed by emplace
+    alignas(T) unsigned char storage_[Capacity][sizeof(T)];
+    pos head_ = 0;
+    pos tail_ = 0;
+};
+
+#endif
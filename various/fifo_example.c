@@ -1,30 +1,49 @@
 #include <stdio.h>
 
+/*
+ * Struct queue_state
+ *
+ * Members:
+ *   head:    index of head
+ *   tail:    index of tail
+ *   count:   number of elements in queue (queue length), 
+ *            maintained by enqueue and dequeue
+ */
+struct queue_state {
+    int head;
+    int tail;
+    int count;
+};
+
 /*
  * Function enqeue
  *
  * Parameters:
  *   fifo:    array of strings (char pointers)
  *   size:    size of array
- *   p_head:  pointer to index of head
- *   p_tail:  pointer to index of tail
+ *   q:       pointer to queue state
  *   arrival: string (char pointer) to be enqueued
  *
  * Return value:
  *   0: no error
  *   1: overflow
  */
-int enqueue(char *fifo[], int size, int *p_head, int *p_tail, char *arrival) {
+int enqueue(char *fifo[], int size, struct queue_state *q, char *arrival) {
     // messages
     puts("\nStepping into enqueue:");
-    printf("  head: %i tail: %i ", *p_head, *p_tail);
+    printf("  head: %i tail: %i count: %i ", q->head, q->tail, q->count);
     printf("arrival: %c%c\\%i \n", *arrival, *(arrival + 1), 
                                    (int) *(arrival + 2));
     // processing
-    fifo[*p_tail] = arrival; 
-    *p_tail = (*p_tail + 1) % size; 
+    // no free slot left - arrival is lost
+    if (q->count == size) {
+        return 1;
+    }
+    fifo[q->tail] = arrival; 
+    q->tail = (q->tail + 1) % size; 
+    q->count++;
     // next slot must be empty, otherwise overflow
-    if (!fifo[*p_tail]) {
+    if (q->count < size) {
         return 0;
     } else {
         return 1;
@@ -37,24 +56,23 @@ int enqueue(char *fifo[], int size, int *p_head, int *p_tail, char *arrival) {
  * Parameters:
  *   fifo:    array of strings (char pointers)
  *   size:    size of array
- *   p_head:  pointer to index of head
- *   p_tail:  pointer to index of tail
+ *   q:       pointer to queue state
  *
  * Return value:
  *   dequeued string (char pointer) 
  *   NULL if queue was empty
  */
-char* dequeue(char *fifo[], int size, int *p_head, int *p_tail) {
+char* dequeue(char *fifo[], int size, struct queue_state *q) {
     // messages
     puts("\nStepping into dequeue:");
-    printf("  head: %i tail: %i \n", *p_head, *p_tail);
+    printf("  head: %i tail: %i count: %i \n", q->head, q->tail, q->count);
     // processing
-    char *departure = fifo[*p_head];
-    if (departure) {
-        fifo[*p_head] = NULL;
-        if (*p_head != *p_tail) {
-            *p_head = (*p_head + 1) % size; 
-        }
+    char *departure = NULL;
+    if (q->count > 0) {
+        departure = fifo[q->head];
+        fifo[q->head] = NULL;
+        q->head = (q->head + 1) % size; 
+        q->count--;
     }
     return departure;
 }
@@ -96,56 +114,54 @@ void print_queue(char *fifo[], int size) {
 int main() {
     int array_size = 3;
     char *fifo[] = {NULL, NULL, NULL};
-    int head = 0;
-    int tail = 0;
-    int *p_head = &head;
-    int *p_tail = &tail;
+    struct queue_state state = {0, 0, 0};
+    struct queue_state *q = &state;
     int status;
     char *departure;
 
     print_queue(fifo, array_size);
 
-    departure = dequeue(fifo, array_size, p_head, p_tail);
+    departure = dequeue(fifo, array_size, q);
     check_departure(departure);
 
     print_queue(fifo, array_size);
 
-    status = enqueue(fifo, array_size, p_head, p_tail, "ab");
+    status = enqueue(fifo, array_size, q, "ab");
     check_status(status);
 
     print_queue(fifo, array_size);
 
-    status = enqueue(fifo, array_size, p_head, p_tail, "cd");
+    status = enqueue(fifo, array_size, q, "cd");
     check_status(status);
 
-    departure = dequeue(fifo, array_size, p_head, p_tail);
+    departure = dequeue(fifo, array_size, q);
     check_departure(departure);
 
     print_queue(fifo, array_size);
 
-    status = enqueue(fifo, array_size, p_head, p_tail, "ef");
+    status = enqueue(fifo, array_size, q, "ef");
     check_status(status);
 
-    departure = dequeue(fifo, array_size, p_head, p_tail);
+    departure = dequeue(fifo, array_size, q);
     check_departure(departure);
 
     print_queue(fifo, array_size);
 
-    departure = dequeue(fifo, array_size, p_head, p_tail);
+    departure = dequeue(fifo, array_size, q);
     check_departure(departure);
 
-    departure = dequeue(fifo, array_size, p_head, p_tail);
+    departure = dequeue(fifo, array_size, q);
     check_departure(departure);
 
     print_queue(fifo, array_size);
 
-    status = enqueue(fifo, array_size, p_head, p_tail, "gh");
+    status = enqueue(fifo, array_size, q, "gh");
     check_status(status);
 
-    status = enqueue(fifo, array_size, p_head, p_tail, "ij");
+    status = enqueue(fifo, array_size, q, "ij");
     check_status(status);
 
-    status = enqueue(fifo, array_size, p_head, p_tail, "kl");
+    status = enqueue(fifo, array_size, q, "kl");
     check_status(status);
 
     print_queue(fifo, array_size);
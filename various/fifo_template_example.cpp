@@ -0,0 +1,70 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "fifo.hpp"
+
+// Helper functions for messages
+
+void check_status(int status) {
+    if (status == 0) {
+        std::puts("ok");
+    } else {
+        std::puts("overflow");
+    }
+}
+
+template <typename T, std::size_t Capacity>
+void print_length(const Fifo<T, Capacity> &fifo) {
+    std::printf("length: %u of %u\n", (unsigned) fifo.length(),
+                (unsigned) fifo.capacity());
+}
+
+// Function main with examples
+
+int main() {
+    /*
+     * Strings stored inline, constructed in place
+     */
+    Fifo<std::string, 4> strings;
+    check_status(strings.enqueue("ab"));
+    check_status(strings.emplace(2, 'c'));
+    std::string ef = "ef";
+    check_status(strings.enqueue(std::move(ef)));
+    check_status(strings.emplace("gh"));
+    check_status(strings.emplace("ij"));
+    print_length(strings);
+    while (auto departure = strings.dequeue()) {
+        std::printf("departure %s\n", departure->c_str());
+    }
+    print_length(strings);
+
+    /*
+     * Move-only elements
+     */
+    Fifo<std::unique_ptr<int>, 2> pointers;
+    check_status(pointers.emplace(new int(1)));
+    check_status(pointers.enqueue(std::make_unique<int>(2)));
+    check_status(pointers.enqueue(std::make_unique<int>(3)));
+    std::printf("front %i\n", *pointers.front());
+    std::printf("departure %i\n", **pointers.dequeue());
+    check_status(pointers.enqueue(std::make_unique<int>(4)));
+    print_length(pointers);
+    // remaining elements destroyed with the queue
+
+    /*
+     * Plain values
+     */
+    Fifo<int, 1024> numbers;
+    long sum = 0;
+    for (int i = 0; i < 1000000; i++) {
+        numbers.enqueue(i);
+        if (i % 2 == 1) {
+            sum += *numbers.dequeue() + *numbers.dequeue();
+        }
+    }
+    std::printf("sum %li\n", sum);
+    print_length(numbers);
+
+    std::puts("\nEnd of program. \n");
+}
@@ -12,6 +12,11 @@
 
 // ARRAY_SIZE:
 // size of array that holds queue
+// a record in flight (transmitted, not yet acknowledged) keeps its slot
+// until acknowledged, so while one is in flight the queue holds one
+// record less before it overflows; check_and_truncate does not count it
+// against QUEUE_CONTROL_LIMIT, so up to QUEUE_CONTROL_LIMIT + 1 slots
+// stay occupied after truncation
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -30,12 +35,25 @@ const int QUEUE_CONTROL_LIMIT = 2;
 // TODO: set to appropriate value
 const int DELAY = 20; //3000;
 
-// array of strings (char arrays) that holds queue
-char fifo[ARRAY_SIZE][STRING_LENGTH];
+// slot of queue: string (char array) with one-byte length header
+// length: string length excluding '\0', set by commit and read by
+// peek_length, so the consumer never scans for '\0'
+// (which slots are occupied follows from head and queue_length - slots
+// are not cleared when items are removed, only overwritten by commit)
+struct slot {
+	unsigned char length;
+	char str[STRING_LENGTH];
+};
+
+// array of slots that holds queue
+struct slot fifo[ARRAY_SIZE];
 
 // other variables for implementation of queueing system
 int head = 0;
 int tail = 0;
+// number of elements in queue, maintained by enqueue, dequeue and
+// check_and_truncate
+int queue_length = 0;
 int iterations = 0;
 
 // status of queueing system
@@ -43,16 +61,19 @@ int iterations = 0;
 // 1: overflow
 int system_status = 0;
 
-// array for string to be enqueued
-char arrival[STRING_LENGTH];
-
 // arrival_status (after attempt to read from serial interface)
-// 0: new string received and copied to arrival
-// 1: no new string - arrival still contains old string
+// 0: new string received and written to reserved tail slot
+// 1: no new string - nothing to commit
 int arrival_status = 0;
 
-// array for dequeued string
-char departure[STRING_LENGTH];
+// length of string written to reserved tail slot (excluding '\0')
+int arrival_length = 0;
+
+// element at head of queue is in flight (transmitted, not yet
+// acknowledged) - it stays in queue until acknowledged
+// 0: no element in flight
+// 1: element at head of queue in flight
+int in_flight = 0;
 
 // status of previous transmission attempt
 // 0: transmission successful
@@ -61,14 +82,15 @@ int transmission_status = 0;
 
 /*
  * function initialize_array
- *   initialize array that holds queue
+ *   initialize array that holds queue (all slots empty)
  */
 void initialize_array() {
 	for (int i = 0; i < ARRAY_SIZE; i++) {
-		for (int j = 0; j < STRING_LENGTH; j++) {
-			fifo[i][j] = '\0';
-		}
+		fifo[i].length = 0;
 	}
+	head = 0;
+	tail = 0;
+	queue_length = 0;
 }
 
 /*
@@ -91,19 +113,6 @@ int get_string_length(char str[]) {
 	return string_length;
 }
 
-/*
- * function set_to_empty_string
- *   overwrite string str with sequence of '\0' of length STRING_LENGTH
- *
- * parameters:
- *   str: string (char array)
- */
-void set_to_empty_string(char str[]) {
-	for (int i = 0; i < STRING_LENGTH; i++) {
-		str[i] = '\0';
-	}
-}
-
 /*
  * function get_queue_length
  *
@@ -111,12 +120,6 @@ void set_to_empty_string(char str[]) {
  *   queue length
  */
 int get_queue_length() {
-	int queue_length = 0;
-	for (int i = 0; i < ARRAY_SIZE; i++) {
-		if (get_string_length(fifo[i]) > 0) {
-			queue_length++;
-		}
-	}
 	return queue_length;
 }
 
@@ -124,11 +127,10 @@ int get_queue_length() {
  * function print_queue
  */
 void print_queue() {
-	int queue_length = 0;
 	char visualization[ARRAY_SIZE + 1];
 	for (int i = 0; i < ARRAY_SIZE; i++) {
-		if (get_string_length(fifo[i]) > 0) {
-			queue_length++;
+		// slot i occupied if within queue_length slots from head
+		if ((i - head + ARRAY_SIZE) % ARRAY_SIZE < queue_length) {
 			visualization[i] = '*';
 		} else {
 			visualization[i] = ' ';
@@ -141,22 +143,50 @@ void print_queue() {
 	Serial.print(" H: ");
 	Serial.print(head);
 	Serial.print(" T: ");
-	Serial.println(tail);
+	Serial.print(tail);
+	Serial.print(" F: ");
+	Serial.println(in_flight);
 }
 
 /*
- * function enqueue
- *   add new item to queue
+ * function reserve
+ *   producer side: get tail slot, so that the next arrival can be written
+ *   directly into queue storage (up to STRING_LENGTH bytes including
+ *   '\0') - the arrival is only enqueued by a subsequent commit
+ *
+ * return value:
+ *   string (char array) of tail slot
+ *   NULL if all slots are occupied
+ */
+char* reserve() {
+	if (queue_length == ARRAY_SIZE) {
+		return NULL;
+	}
+	return fifo[tail].str;
+}
+
+/*
+ * function commit
+ *   producer side: add string written to reserved tail slot to queue
+ *
+ * parameters:
+ *   len: string length excluding '\0' (at most STRING_LENGTH - 1)
  *
  * return value:
  *   0: no error
  *   1: overflow
  */
-int enqueue() {
-	strcpy(fifo[tail], arrival);
+int commit(int len) {
+	// no slot reserved - arrival is lost
+	if (queue_length == ARRAY_SIZE) {
+		return 1;
+	}
+	fifo[tail].length = len;
+	fifo[tail].str[len] = '\0';
 	tail = (tail + 1) % ARRAY_SIZE;
+	queue_length++;
 	// next slot must be empty, otherwise overflow
-	if (get_string_length(fifo[tail]) == 0) {
+	if (queue_length < ARRAY_SIZE) {
 		return 0;
 	} else {
 		return 1;
@@ -164,61 +194,120 @@ int enqueue() {
 }
 
 /*
- * function dequeue
- *   remove item from queue, FIFO
- *   removed value is copied to departure
+ * function peek
+ *   consumer side: read string at head of queue in place
+ *   (remains in queue until release)
+ *
+ * return value:
+ *   string (char array) of head slot
+ *   NULL if queue is empty
+ */
+char* peek() {
+	if (queue_length == 0) {
+		return NULL;
+	}
+	return fifo[head].str;
+}
+
+/*
+ * function peek_length
+ *   consumer side: length of string at head of queue, read from the
+ *   length header of the slot
+ *
+ * return value:
+ *   string length excluding '\0'
+ *   0 if queue is empty
  */
-void dequeue() {
-	strcpy(departure, fifo[head]);
-	set_to_empty_string(fifo[head]);
-	if (head != tail) {
-		head = (head + 1) % ARRAY_SIZE;
+int peek_length() {
+	if (queue_length == 0) {
+		return 0;
+	}
+	return fifo[head].length;
+}
+
+/*
+ * function release
+ *   consumer side: remove item at head of queue, FIFO
+ *   (no change if queue is empty)
+ */
+void release() {
+	if (queue_length == 0) {
+		return;
+	}
+	head = (head + 1) % ARRAY_SIZE;
+	queue_length--;
+}
+
+/*
+ * function start_transmission
+ *   mark item at head of queue as in flight, if queue is not empty
+ *   (item is only removed from queue when its transmission has been
+ *   acknowledged, see function transmission_status_and_cleanup)
+ */
+void start_transmission() {
+	if (peek()) {
+		in_flight = 1;
 	}
 }
 
 /*
  * function check_and_truncate
  *   if queue length exceeds the limit, truncate to this limit
- *   (current implementation: truncate starting from head of queue)
+ *   (current implementation: truncate starting from head of queue;
+ *   an item in flight is neither counted against the limit nor dropped -
+ *   items behind it are dropped instead)
+ *   head is advanced past all dropped items in one step, dropped slots
+ *   are not cleared
  *
  * parameters:
  *   limit:   desired limit of queue length
  */
 void check_and_truncate(int limit) {
-	int queue_length = get_queue_length();
-	while ((get_string_length(fifo[head]) > 0) && (queue_length > limit)) {
-		set_to_empty_string(fifo[head]);
-		head = (head + 1) % ARRAY_SIZE;
-		queue_length--;
+	int excess = queue_length - in_flight - limit;
+	if (excess <= 0) {
+		return;
 	}
+	int next = (head + excess) % ARRAY_SIZE;
+	if (in_flight) {
+		// keep item in flight: move it over the last dropped item
+		fifo[next] = fifo[head];
+	}
+	head = next;
+	queue_length -= excess;
 }
 
 /*
  * function get_next_arrival
  *   try to read next data package (string) from serial interface
+ *   directly into reserved tail slot of queue (see reserve and commit)
  *
  * return value:
- *   0: new string received and copied to array arrival
- *   1: no new string - array arrival still contains old string
+ *   0: new string received and written to tail slot,
+ *      length stored in arrival_length
+ *   1: no new string (or no free slot) - nothing to commit
  */
 int get_next_arrival() {
 	int status = 0;
-	char str[STRING_LENGTH];
-	set_to_empty_string(str);
+	char *str = reserve();
+	// leave data in serial buffer until a slot is free
+	if (!str) {
+		return 1;
+	}
 
 	// TODO: uncomment and check carefully once serial interface 1 is set up
 	/*
 	// read new string from serial interface, if available
-	// (up to string_length bytes including \0)
+	// (up to STRING_LENGTH - 1 bytes, commit adds \0)
 	if (Serial1.available()) {
 		status = 0;
 		// delay allows all bytes sent to be received together
 		delay(100);
 		int i = 0;
-		while (Serial1.available() && i < string_length) {
+		while (Serial1.available() && i < STRING_LENGTH - 1) {
 			str[i] = Serial1.read();
 			i++;
 		}
+		arrival_length = i;
 	} else {
 		status = 1;
 	}
@@ -239,14 +328,13 @@ int get_next_arrival() {
 		} else {
 			strcpy(str, dummy_input_2);
 		}
+		arrival_length = get_string_length(str);
 	} else {
 		// simulating failure to read new value from serial interface
 		status = 1;
 	}
 	// SIMULATION CODE END
 
-	// copy input string to arrival
-	strcpy(arrival, str);
 	return status;
 }
 
@@ -255,8 +343,8 @@ int get_next_arrival() {
  *   asynchronous checking of transmission status -
  *   transmission status received via downlink message
  *
- *   cleanup: departure is set to empty string if
- *   previous transmission was successful
+ *   cleanup: item in flight is removed from queue if
+ *   previous transmission was successful (commit on acknowledgement)
  *
  * return value:
  *   0: previous transmission successful
@@ -266,7 +354,10 @@ int transmission_status_and_cleanup() {
 	// TODO: replace simulation code with actual check
 	if (rand() % 100 < 20) {
 		// previous transmission successful
-		set_to_empty_string(departure);
+		if (in_flight) {
+			release();
+			in_flight = 0;
+		}
 		return 0;
 	} else {
 		// previous transmission failed
@@ -276,7 +367,8 @@ int transmission_status_and_cleanup() {
 
 /*
  * function transmit
- *   try to transmit dequeued string (departure) via LoRa network
+ *   try to transmit item in flight via LoRa network,
+ *   read in place from head of queue
  *
  * no return value
  *  (asynchronous checking of transmission status -
@@ -285,9 +377,14 @@ int transmission_status_and_cleanup() {
  */
 void transmit() {
 	// TODO: replace messages with code for transmission via LoRa uplink
-	if (get_string_length(departure) > 0) {
-		Serial.print("to be transmitted: ");
-		Serial.println(departure);
+	if (in_flight) {
+		// length from slot header: payload handed over as buffer and
+		// length, as for the LoRa uplink
+		Serial.print("to be transmitted (");
+		Serial.print(peek_length());
+		Serial.print(" bytes): ");
+		Serial.write(peek(), peek_length());
+		Serial.println("");
 	} else {
 		Serial.print("no departure to transmit.");
 	}
@@ -327,9 +424,7 @@ void setup() {
 
 	// initialize array that holds queue
 	initialize_array();
-	// initialize arrival and departure strings
-	set_to_empty_string(arrival);
-	set_to_empty_string(departure);
+	in_flight = 0;
 	Serial.println("");
 	Serial.println("setup completed.");
 	Serial.println("");
@@ -344,7 +439,7 @@ void loop() {
 		Serial.println(arrival_status);
 		// enqueueing next data package if available
 		if (arrival_status == 0) {
-			system_status = enqueue();
+			system_status = commit(arrival_length);
 		}
 		// get transmission_status of previous transmission to LoRa
 		// gateway by checking if a confirmation message has been
@@ -352,13 +447,14 @@ void loop() {
 		transmission_status = transmission_status_and_cleanup();
 		Serial.print("transmission status: ");
 		Serial.println(transmission_status);
-		// dequeueing only if last transmission was successful
+		// next item only if last transmission was successful
+		// (acknowledged item has been removed from queue)
 		if (transmission_status == 0) {
-			dequeue();
-			// try to transmit new departure
+			start_transmission();
+			// try to transmit new item in flight
 			transmit();
 		} else {
-			// do not dequeue,
+			// keep item in flight at head of queue,
 			// retry transmission
 			transmit();
 		}
@@ -1,5 +1,27 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/*
+ * Struct queue_state
+ *
+ * Members:
+ *   head:    index of head
+ *   tail:    index of tail
+ *   count:   number of elements in queue (queue length), 
+ *            maintained by enqueue and dequeue
+ *   stamps:  array of enqueue times (simulation steps), parallel to
+ *            array of strings - NULL if not tracked
+ *   now:     current simulation step (recorded by enqueue in stamps)
+ */
+struct queue_state {
+    int head;
+    int tail;
+    int count;
+    int *stamps;
+    int now;
+};
 
 /*
  * Function enqueue
@@ -7,19 +29,26 @@
  * Parameters:
  *   fifo:    array of strings (char pointers)
  *   size:    size of array
- *   p_head:  pointer to index of head
- *   p_tail:  pointer to index of tail
+ *   q:       pointer to queue state
  *   arrival: string (char pointer) to be enqueued
  *
  * Return value:
  *   0: no error
  *   1: overflow
  */
-int enqueue(char *fifo[], int size, int *p_head, int *p_tail, char *arrival) {
-    fifo[*p_tail] = arrival; 
-    *p_tail = (*p_tail + 1) % size; 
+int enqueue(char *fifo[], int size, struct queue_state *q, char *arrival) {
+    // no free slot left - arrival is lost
+    if (q->count == size) {
+        return 1;
+    }
+    fifo[q->tail] = arrival; 
+    if (q->stamps) {
+        q->stamps[q->tail] = q->now;
+    }
+    q->tail = (q->tail + 1) % size; 
+    q->count++;
     // next slot must be empty, otherwise overflow
-    if (!fifo[*p_tail]) {
+    if (q->count < size) {
         return 0;
     } else {
         return 1;
@@ -32,45 +61,610 @@ int enqueue(char *fifo[], int size, int *p_head, int *p_tail, char *arrival) {
  * Parameters:
  *   fifo:    array of strings (char pointers)
  *   size:    size of array
- *   p_head:  pointer to index of head
- *   p_tail:  pointer to index of tail
+ *   q:       pointer to queue state
  *
  * Return value:
  *   dequeued string (char pointer) 
  *   NULL if queue was empty
  */
-char* dequeue(char *fifo[], int size, int *p_head, int *p_tail) {
-    char *departure = fifo[*p_head];
-    if (departure) {
-        fifo[*p_head] = NULL;
-        if (*p_head != *p_tail) {
-            *p_head = (*p_head + 1) % size; 
-        }
+char* dequeue(char *fifo[], int size, struct queue_state *q) {
+    char *departure = NULL;
+    if (q->count > 0) {
+        departure = fifo[q->head];
+        fifo[q->head] = NULL;
+        q->head = (q->head + 1) % size; 
+        q->count--;
     }
     return departure;
 }
 
+/*
+ * Enum drop_policy_index
+ *   index of the drop policies of this file in the per-policy counters of 
+ *   drop_sink (DROP_POLICIES: number of policies)
+ */
+enum drop_policy_index {
+    DROP_HEAD,
+    DROP_TAIL,
+    DROP_RANDOM,
+    DROP_BY_AGE,
+    DROP_POLICIES
+};
+
+/*
+ * Struct drop_sink
+ *   receives elements dropped by check_and_truncate and keeps count of
+ *   them, in total and per drop policy
+ *
+ * Members:
+ *   receive:        called with each contiguous span of dropped elements 
+ *                   before they are removed - at most two spans (around 
+ *                   end of array) per call of check_and_truncate; NULL: no 
+ *                   callback
+ *   context:        passed to receive
+ *   dropped:        total number of dropped elements
+ *   bytes:          total length of dropped strings (excluding '\0')
+ *   policy_dropped: number of dropped elements per drop policy (see enum 
+ *                   drop_policy_index; other policies: total only)
+ *   policy_bytes:   length of dropped strings per drop policy
+ */
+struct drop_sink {
+    void (*receive)(char *span[], int n, void *context);
+    void *context;
+    long dropped;
+    long bytes;
+    long policy_dropped[DROP_POLICIES];
+    long policy_bytes[DROP_POLICIES];
+};
+
+/*
+ * Function span_bytes
+ *
+ * Return value:
+ *   total length of n strings (excluding '\0')
+ */
+long span_bytes(char *span[], int n) {
+    long bytes = 0;
+    for (int i = 0; i < n; i++) {
+        bytes += strlen(span[i]);
+    }
+    return bytes;
+}
+
+/*
+ * Function drop_slots
+ *   hand n consecutive slots starting at index first to sink (if any) and 
+ *   set them to NULL (at most two spans and two memset calls, around end 
+ *   of array) - does not change queue state
+ */
+void drop_slots(char *fifo[], int size, int first, int n, 
+                struct drop_sink *sink) {
+    int k = size - first < n ? size - first : n;
+    if (sink) {
+        if (sink->receive) {
+            sink->receive(fifo + first, k, sink->context);
+            if (n > k) {
+                sink->receive(fifo, n - k, sink->context);
+            }
+        }
+        sink->bytes += span_bytes(fifo + first, k) + span_bytes(fifo, n - k);
+        sink->dropped += n;
+    }
+    memset(fifo + first, 0, k * sizeof(char *));
+    memset(fifo, 0, (n - k) * sizeof(char *));
+}
+
+/*
+ * Function drop_first
+ *   drop n elements from head of queue in one step
+ */
+void drop_first(char *fifo[], int size, struct queue_state *q, int n,
+                struct drop_sink *sink) {
+    drop_slots(fifo, size, q->head, n, sink);
+    q->head = (q->head + n) % size;
+    q->count -= n;
+}
+
+/*
+ * Type drop_policy
+ *   strategy used by check_and_truncate to select and drop elements
+ *
+ * Parameters:
+ *   fifo:    array of strings (char pointers)
+ *   size:    size of array
+ *   q:       pointer to queue state
+ *   limit:   limit passed to check_and_truncate
+ *   sink:    receives dropped elements (NULL: dropped silently)
+ *
+ * Return value:
+ *   number of dropped elements
+ */
+typedef int (*drop_policy)(char *fifo[], int size, struct queue_state *q,
+                           int limit, struct drop_sink *sink);
+
+/*
+ * Function drop_head
+ *   if queue length exceeds limit, drop the excess elements from head of 
+ *   queue in one step: head is advanced by (queue length - limit)
+ */
+int drop_head(char *fifo[], int size, struct queue_state *q, int limit,
+              struct drop_sink *sink) {
+    if (q->count <= limit) {
+        return 0;
+    }
+    int excess = q->count - limit;
+    drop_first(fifo, size, q, excess, sink);
+    return excess;
+}
+
+/*
+ * Function drop_tail
+ *   if queue length exceeds limit, drop the excess elements from tail of 
+ *   queue (the most recent arrivals) in one step
+ */
+int drop_tail(char *fifo[], int size, struct queue_state *q, int limit,
+              struct drop_sink *sink) {
+    if (q->count <= limit) {
+        return 0;
+    }
+    int excess = q->count - limit;
+    q->tail = (q->tail - excess + size) % size;
+    drop_slots(fifo, size, q->tail, excess, sink);
+    q->count = limit;
+    return excess;
+}
+
+int compare_int(const void *a, const void *b) {
+    return *(const int *) a - *(const int *) b;
+}
+
+/*
+ * Function sample_offsets
+ *   choose k distinct offsets out of 0 .. n - 1 uniformly at random with 
+ *   Floyd's sampling algorithm, in ascending order - membership is tested 
+ *   in an open-addressing hash set of at least 2k entries (heap), so the 
+ *   work done is O(k log k), independent of n
+ *
+ * Parameters:
+ *   n:       number of offsets to choose from
+ *   k:       number of offsets to choose (0 < k <= n)
+ *   offsets: array of k ints (output)
+ *
+ * Return value:
+ *   0: no error
+ *   1: out of memory
+ */
+int sample_offsets(int n, int k, int offsets[]) {
+    int capacity = 4;
+    while (capacity < 2 * k) {
+        capacity *= 2;
+    }
+    // entries are offset + 1, 0: empty
+    int *set = calloc(capacity, sizeof(int));
+    if (!set) {
+        return 1;
+    }
+    for (int i = 0, j = n - k; j < n; i++, j++) {
+        int t = rand() % (j + 1);
+        int slot = (int) ((unsigned) t * 2654435761u) & (capacity - 1);
+        while (set[slot] != 0 && set[slot] != t + 1) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        if (set[slot] != 0) {
+            // t chosen before - j is not, as only offsets < j were offered
+            t = j;
+            slot = (int) ((unsigned) t * 2654435761u) & (capacity - 1);
+            while (set[slot] != 0) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+        }
+        set[slot] = t + 1;
+        offsets[i] = t;
+    }
+    free(set);
+    qsort(offsets, k, sizeof(int), compare_int);
+    return 0;
+}
+
+/*
+ * Function swap_slots
+ *   swap elements (and enqueue times, if tracked) at offsets a and b from 
+ *   head of queue
+ */
+void swap_slots(char *fifo[], int size, struct queue_state *q, int a, 
+                int b) {
+    int from = (q->head + a) % size;
+    int to = (q->head + b) % size;
+    char *element = fifo[to];
+    fifo[to] = fifo[from];
+    fifo[from] = element;
+    if (q->stamps) {
+        int stamp = q->stamps[to];
+        q->stamps[to] = q->stamps[from];
+        q->stamps[from] = stamp;
+    }
+}
+
+/*
+ * Function drop_random
+ *   if queue length exceeds limit, keep a uniformly random subset of limit 
+ *   elements (in their order), drop all others
+ *   the smaller of the two sets (survivors or dropped elements) is chosen 
+ *   with sample_offsets, O(m log m) for m = min(limit, excess); survivors 
+ *   are then moved next to tail in order: at most limit moves if 
+ *   survivors were chosen, else only the survivors in front of the last 
+ *   dropped element move (no comparisons); the dropped elements end up 
+ *   (in some order) in the slots from head on
+ *   if out of memory, the excess elements are dropped from head instead
+ */
+int drop_random(char *fifo[], int size, struct queue_state *q, int limit,
+                struct drop_sink *sink) {
+    if (q->count <= limit) {
+        return 0;
+    }
+    int excess = q->count - limit;
+    if (limit == 0) {
+        drop_first(fifo, size, q, excess, sink);
+        return excess;
+    }
+    int keep = limit <= excess;
+    int m = keep ? limit : excess;
+    int *offsets = malloc(m * sizeof(int));
+    if (!offsets || sample_offsets(q->count, m, offsets) != 0) {
+        free(offsets);
+        return drop_head(fifo, size, q, limit, sink);
+    }
+    if (keep) {
+        // swap survivors into the last limit slots, starting with the 
+        // last one (target offset is never smaller than source offset, so 
+        // only dropped elements are swapped towards head)
+        for (int i = limit - 1; i >= 0; i--) {
+            swap_slots(fifo, size, q, offsets[i], excess + i);
+        }
+    } else {
+        // walk from last dropped element towards head: slots after to 
+        // hold survivors in order, slots after j up to to hold dropped 
+        // elements
+        int k = excess - 1;
+        int to = offsets[k];
+        for (int j = offsets[k]; j >= 0; j--) {
+            if (k >= 0 && j == offsets[k]) {
+                k--;
+            } else {
+                swap_slots(fifo, size, q, j, to--);
+            }
+        }
+    }
+    free(offsets);
+    drop_first(fifo, size, q, excess, sink);
+    return excess;
+}
+
+/*
+ * Function drop_by_age
+ *   drop elements older than limit simulation steps (age: now - enqueue 
+ *   time), oldest first - in a FIFO queue these are found at head of 
+ *   queue, so only dropped elements are visited
+ *   (requires q->stamps, otherwise nothing is dropped)
+ */
+int drop_by_age(char *fifo[], int size, struct queue_state *q, int limit,
+                struct drop_sink *sink) {
+    int n = 0;
+    if (!q->stamps) {
+        return 0;
+    }
+    while (n < q->count && q->now - q->stamps[(q->head + n) % size] > limit) {
+        n++;
+    }
+    drop_first(fifo, size, q, n, sink);
+    return n;
+}
+
 /*
  * Function check_and_truncate
  *
  * Parameters:
  *   fifo:    array of strings (char pointers)
  *   size:    size of array
- *   p_head:  pointer to index of head
+ *   q:       pointer to queue state
  *   limit:   if queue length exceeds this limit, truncate to this limit
+ *            (drop_by_age: maximum age of elements)
+ *   policy:  drop policy (drop_head, drop_tail, drop_random, drop_by_age)
+ *   sink:    receives dropped elements (NULL: dropped silently), 
+ *            counted in total and for policy
+ *
+ * Return value:
+ *   number of dropped elements
  */
-void check_and_truncate(char *fifo[], int size, int *p_head, int limit) {
-    int queue_length = 0;
-    for(int i = 0; i < size; i++) {
-        if (fifo[i]) {
-            queue_length++;
+int check_and_truncate(char *fifo[], int size, struct queue_state *q, 
+                       int limit, drop_policy policy, 
+                       struct drop_sink *sink) {
+    // in order of enum drop_policy_index
+    const drop_policy policies[DROP_POLICIES] = {
+        drop_head, drop_tail, drop_random, drop_by_age
+    };
+    if (!sink) {
+        return policy(fifo, size, q, limit, sink);
+    }
+    long bytes = sink->bytes;
+    int dropped = policy(fifo, size, q, limit, sink);
+    for (int i = 0; i < DROP_POLICIES; i++) {
+        if (policy == policies[i]) {
+            sink->policy_dropped[i] += dropped;
+            sink->policy_bytes[i] += sink->bytes - bytes;
         }
     }
-    while (fifo[*p_head] && queue_length > limit) {
-        fifo[*p_head] = NULL; 
-        *p_head = (*p_head + 1) % size; 
-        queue_length--;
-    } 
+    return dropped;
+}
+
+/*
+ * Struct codel
+ *   state of CoDel controller (Nichols and Jacobson, RFC 8289), with time 
+ *   measured in simulation steps
+ *
+ * Members:
+ *   target:           acceptable minimum sojourn time
+ *   interval:         sojourn time must stay above target for this long 
+ *                     before dropping starts
+ *   first_above_time: time when sojourn time will have been above target 
+ *                     for interval (0: sojourn time below target)
+ *   drop_next:        time of next drop while dropping
+ *   count:            number of drops since start of dropping state
+ *   last_count:       count at end of previous dropping state
+ *   dropping:         1: in dropping state, 0: otherwise
+ *   dropped:          total number of dropped elements
+ *   sojourn:          sojourn time of element dequeued last
+ */
+struct codel {
+    int target;
+    int interval;
+    int first_above_time;
+    int drop_next;
+    int count;
+    int last_count;
+    int dropping;
+    int dropped;
+    int sojourn;
+};
+
+/*
+ * Function codel_control_law
+ *   time of next drop: interval / sqrt(count) after t
+ */
+int codel_control_law(struct codel *c, int t) {
+    return t + (int) (c->interval / sqrt(c->count));
+}
+
+/*
+ * Function codel_do_dequeue
+ *   dequeue element and check whether sojourn time has stayed above 
+ *   target for at least interval
+ *
+ * Parameters:
+ *   ok_to_drop: set to 1 if dequeued element may be dropped, else 0
+ *
+ * Return value:
+ *   dequeued string (char pointer)
+ *   NULL if queue was empty
+ */
+char* codel_do_dequeue(char *fifo[], int size, struct queue_state *q,
+                       struct codel *c, int *ok_to_drop) {
+    *ok_to_drop = 0;
+    if (q->count == 0) {
+        c->first_above_time = 0;
+        return NULL;
+    }
+    c->sojourn = q->now - q->stamps[q->head];
+    char *departure = dequeue(fifo, size, q);
+    if (c->sojourn < c->target) {
+        c->first_above_time = 0;
+    } else if (c->first_above_time == 0) {
+        c->first_above_time = q->now + c->interval;
+    } else if (q->now >= c->first_above_time) {
+        *ok_to_drop = 1;
+    }
+    return departure;
+}
+
+/*
+ * Function codel_dequeue
+ *   dequeue with CoDel control: elements are dropped at head of queue only 
+ *   when the sojourn time has stayed above target for a full interval, 
+ *   at a rate increasing with the square root of the number of drops
+ *   (requires q->stamps and q->now)
+ *
+ * Parameters:
+ *   fifo:    array of strings (char pointers)
+ *   size:    size of array
+ *   q:       pointer to queue state
+ *   c:       pointer to CoDel state
+ *
+ * Return value:
+ *   dequeued string (char pointer)
+ *   NULL if queue was empty (or all remaining elements were dropped)
+ */
+char* codel_dequeue(char *fifo[], int size, struct queue_state *q,
+                    struct codel *c) {
+    int ok_to_drop;
+    char *departure = codel_do_dequeue(fifo, size, q, c, &ok_to_drop);
+    if (!departure) {
+        // empty queue ends dropping state (first_above_time already 
+        // cleared): a burst after an idle gap starts over
+        c->dropping = 0;
+        return NULL;
+    }
+    if (c->dropping) {
+        if (!ok_to_drop) {
+            // sojourn time below target - leave dropping state
+            c->dropping = 0;
+        }
+        while (c->dropping && q->now >= c->drop_next) {
+            c->dropped++;
+            c->count++;
+            departure = codel_do_dequeue(fifo, size, q, c, &ok_to_drop);
+            if (!ok_to_drop) {
+                c->dropping = 0;
+            } else {
+                c->drop_next = codel_control_law(c, c->drop_next);
+            }
+        }
+    } else if (ok_to_drop) {
+        c->dropped++;
+        departure = codel_do_dequeue(fifo, size, q, c, &ok_to_drop);
+        c->dropping = 1;
+        // start with drop rate of previous dropping state if it ended 
+        // recently
+        int delta = c->count - c->last_count;
+        if (delta > 1 && q->now - c->drop_next < 16 * c->interval) {
+            c->count = delta;
+        } else {
+            c->count = 1;
+        }
+        c->drop_next = codel_control_law(c, q->now);
+        c->last_count = c->count;
+    }
+    if (!departure) {
+        // queue emptied by drops: leave dropping state as well
+        c->dropping = 0;
+    }
+    return departure;
+}
+
+/*
+ * Struct red
+ *   state of Random Early Detection admission (Floyd and Jacobson, 1993)
+ *
+ * Members:
+ *   weight:    weight of current queue length in moving average
+ *   min_th:    below this average queue length all arrivals are admitted
+ *   max_th:    above this average queue length all arrivals are rejected
+ *   max_p:     rejection probability when average reaches max_th
+ *   avg:       exponentially weighted moving average of queue length
+ *   count:     arrivals admitted since last rejection (-1: avg < min_th)
+ *   rejected:  total number of rejected arrivals
+ */
+struct red {
+    double weight;
+    double min_th;
+    double max_th;
+    double max_p;
+    double avg;
+    int count;
+    int rejected;
+};
+
+/*
+ * Function red_admit
+ *   update moving average of queue length, decide on admission with a 
+ *   probability of rejection rising linearly from 0 at min_th to max_p at 
+ *   max_th (spread out evenly by count) - constant time
+ *
+ * Return value:
+ *   1: arrival admitted
+ *   0: arrival rejected
+ */
+int red_admit(struct red *r, struct queue_state *q) {
+    r->avg = (1 - r->weight) * r->avg + r->weight * q->count;
+    if (r->avg < r->min_th) {
+        r->count = -1;
+        return 1;
+    }
+    if (r->avg < r->max_th) {
+        r->count++;
+        double pb = r->max_p * (r->avg - r->min_th) / (r->max_th - r->min_th);
+        double pa = r->count * pb < 1 ? pb / (1 - r->count * pb) : 1;
+        if (rand() / (RAND_MAX + 1.0) >= pa) {
+            return 1;
+        }
+    }
+    r->count = 0;
+    return 0;
+}
+
+/*
+ * Function red_enqueue
+ *   enqueue with RED admission: arrival may be rejected before it enters 
+ *   the queue, keeping the queue short continuously
+ *
+ * Parameters:
+ *   fifo:    array of strings (char pointers)
+ *   size:    size of array
+ *   q:       pointer to queue state
+ *   r:       pointer to RED state
+ *   arrival: string (char pointer) to be enqueued
+ *
+ * Return value:
+ *   0: no error (arrival enqueued or rejected)
+ *   1: overflow
+ */
+int red_enqueue(char *fifo[], int size, struct queue_state *q, struct red *r,
+                char *arrival) {
+    if (!red_admit(r, q)) {
+        r->rejected++;
+        return 0;
+    }
+    return enqueue(fifo, size, q, arrival);
+}
+
+/*
+ * Struct length_state
+ *   queue as birth-death process: statistics of queue length do not depend 
+ *   on the elements, so only the length is tracked (no array, no strings)
+ *
+ * Members:
+ *   length:  number of elements in queue (queue length)
+ *   dropped: number of elements dropped by truncation
+ */
+struct length_state {
+    int length;
+    int dropped;
+};
+
+/*
+ * Function length_step
+ *   one time step: arrival first, then departure if queue is not empty 
+ *   (same order as enqueue followed by dequeue)
+ *
+ * Parameters:
+ *   l:         pointer to length state
+ *   size:      maximum queue length (size of array in FIFO path)
+ *   arrival:   1: arrival in this step, 0: no arrival
+ *   departure: 1: departure attempted in this step, 0: none
+ *
+ * Return value:
+ *   0: no error
+ *   1: overflow (same as enqueue)
+ */
+int length_step(struct length_state *l, int size, int arrival, 
+                int departure) {
+    int status = 0;
+    if (arrival) {
+        if (l->length == size) {
+            return 1;
+        }
+        l->length++;
+        status = l->length == size;
+    }
+    l->length -= departure & (l->length > 0);
+    return status;
+}
+
+/*
+ * Function length_truncate
+ *   truncate queue to limit elements (as check_and_truncate with drop_head 
+ *   or drop_tail)
+ *
+ * Return value:
+ *   number of dropped elements
+ */
+int length_truncate(struct length_state *l, int limit) {
+    if (l->length <= limit) {
+        return 0;
+    }
+    int excess = l->length - limit;
+    l->length = limit;
+    l->dropped += excess;
+    return excess;
 }
 
 // Helper functions for messages
@@ -84,19 +678,52 @@ void check_departure(char *departure) {
     }
 }
 
-void show_queue(char *fifo[], int array_size) {
-    int queue_length = 0;
+void print_drops(char *span[], int n, void *context) {
+    (void) context;
+    printf("dropped %i:", n);
+    for (int i = 0; i < n; i++) {
+        printf(" %s", span[i]);
+    }
+    printf("\n");
+}
+
+void print_summary(int departures, int dropped, long sojourn) {
+    printf("departures: %i dropped: %i mean sojourn time: %.2f\n",
+           departures, dropped, 
+           departures > 0 ? (double) sojourn / departures : 0.0);
+}
+
+void print_length_stats(long hist[], int size, long steps, int dropped) {
+    long sum = 0;
+    int max = 0;
+    int median = -1;
+    long cumulative = 0;
+    for (int i = 0; i <= size; i++) {
+        sum += i * hist[i];
+        if (hist[i] > 0) {
+            max = i;
+        }
+        cumulative += hist[i];
+        if (median < 0 && 2 * cumulative >= steps) {
+            median = i;
+        }
+    }
+    printf("steps: %li queue length zero (%%): %.1f median: %i mean: %.2f "
+           "max: %i dropped: %i\n", steps, 100.0 * hist[0] / steps, median, 
+           (double) sum / steps, max, dropped);
+}
+
+void show_queue(char *fifo[], int array_size, struct queue_state *q) {
     char visualization[array_size + 1];  
     for(int i = 0; i < array_size; i++) {
         if (fifo[i]) {
-            queue_length++;
             visualization[i] = '*';
         } else {
             visualization[i] = ' ';
         }
     }
     visualization[array_size] = '\0';
-    printf(" %s %i\n", visualization, queue_length);
+    printf(" %s %i\n", visualization, q->count);
 }
 
 // Function main with examples
@@ -107,13 +734,28 @@ int main() {
                     NULL, NULL, NULL, NULL, NULL, 
                     NULL, NULL, NULL, NULL, NULL, 
                     NULL, NULL, NULL, NULL, NULL};
-    int head = 0;
-    int tail = 0;
-    int *p_head = &head;
-    int *p_tail = &tail;
+    int stamps[20] = {0};
+    struct queue_state state = {0, 0, 0, NULL, 0};
+    struct queue_state *q = &state;
     int status = 0;
     int iterations = 0;
     char *departure;
+    // statistics for examples comparing drop policies
+    int departures = 0;
+    int dropped = 0;
+    // dropped elements are printed and counted
+    struct drop_sink sink = {print_drops, NULL, 0, 0, {0}, {0}};
+    long sojourn = 0;
+    int age = 0;
+    // CoDel with target 3 steps and interval 30 steps
+    struct codel codel = {3, 30, 0, 0, 0, 0, 0, 0, 0};
+    // RED with weight 0.2, thresholds 2 and 6, maximum probability 0.1
+    struct red red = {0.2, 2, 6, 0.1, 0, -1, 0};
+    // queue length only, for examples without array
+    struct length_state length = {0, 0};
+    long hist[21] = {0};
+    int arrival;
+    int attempt;
 
     // Choose example (see below)
     int EXAMPLE = 10;
@@ -126,8 +768,8 @@ int main() {
     case 1:
         while ((status == 0) && (iterations < 100)) {
             iterations++;
-            status = enqueue(fifo, array_size, p_head, p_tail, "ab");
-            show_queue(fifo, array_size);
+            status = enqueue(fifo, array_size, q, "ab");
+            show_queue(fifo, array_size, q);
         }
         if (status == 1) {
             puts("OVERFLOW!"); 
@@ -141,12 +783,12 @@ int main() {
     case 2:
         while ((status == 0) && (iterations < 100)) {
             iterations++;
-            status = enqueue(fifo, array_size, p_head, p_tail, "ab");
+            status = enqueue(fifo, array_size, q, "ab");
             if (iterations % 2 == 0) {
-                departure = dequeue(fifo, array_size, p_head, p_tail);
+                departure = dequeue(fifo, array_size, q);
                 //check_departure(departure);
             }
-            show_queue(fifo, array_size);
+            show_queue(fifo, array_size, q);
         }
         if (status == 1) {
             puts("OVERFLOW!"); 
@@ -163,12 +805,12 @@ int main() {
         while ((status == 0) && (iterations < 1000)) {
             iterations++;
             if (rand() % 100 < 50) {
-                status = enqueue(fifo, array_size, p_head, p_tail, "ab");
+                status = enqueue(fifo, array_size, q, "ab");
             }
             if (rand() % 100 < 50) {
-                departure = dequeue(fifo, array_size, p_head, p_tail);
+                departure = dequeue(fifo, array_size, q);
             }
-            show_queue(fifo, array_size);
+            show_queue(fifo, array_size, q);
         }
         if (status == 1) {
             puts("OVERFLOW!"); 
@@ -185,12 +827,12 @@ int main() {
         while ((status == 0) && (iterations < 1000)) {
             iterations++;
             if (rand() % 100 < 20) {
-                status = enqueue(fifo, array_size, p_head, p_tail, "ab");
+                status = enqueue(fifo, array_size, q, "ab");
             }
             if (rand() % 100 < 40) {
-                departure = dequeue(fifo, array_size, p_head, p_tail);
+                departure = dequeue(fifo, array_size, q);
             }
-            show_queue(fifo, array_size);
+            show_queue(fifo, array_size, q);
         }
         if (status == 1) {
             puts("OVERFLOW!"); 
@@ -207,12 +849,12 @@ int main() {
         while ((status == 0) && (iterations < 1000)) {
             iterations++;
             if (rand() % 100 < 40) {
-                status = enqueue(fifo, array_size, p_head, p_tail, "ab");
+                status = enqueue(fifo, array_size, q, "ab");
             }
             if (rand() % 100 < 20) {
-                departure = dequeue(fifo, array_size, p_head, p_tail);
+                departure = dequeue(fifo, array_size, q);
             }
-            show_queue(fifo, array_size);
+            show_queue(fifo, array_size, q);
         }
         if (status == 1) {
             puts("OVERFLOW!"); 
@@ -229,12 +871,12 @@ int main() {
         while ((status == 0) && (iterations < 1000)) {
             iterations++;
             if (rand() % 100 < 49) {
-                status = enqueue(fifo, array_size, p_head, p_tail, "ab");
+                status = enqueue(fifo, array_size, q, "ab");
             }
             if (rand() % 100 < 52) {
-                departure = dequeue(fifo, array_size, p_head, p_tail);
+                departure = dequeue(fifo, array_size, q);
             }
-            show_queue(fifo, array_size);
+            show_queue(fifo, array_size, q);
         }
         if (status == 1) {
             puts("OVERFLOW!"); 
@@ -251,16 +893,16 @@ int main() {
         while ((status == 0) && (iterations < 1000)) {
             iterations++;
             if (rand() % 100 < 40) {
-                status = enqueue(fifo, array_size, p_head, p_tail, "ab");
+                status = enqueue(fifo, array_size, q, "ab");
             }
             if (rand() % 100 < 20) {
-                departure = dequeue(fifo, array_size, p_head, p_tail);
+                departure = dequeue(fifo, array_size, q);
             }
             // truncate every 10 steps to 2 elements in  queue
             if (iterations % 10 == 0) {
-                check_and_truncate(fifo, array_size, p_head, 2);
+                check_and_truncate(fifo, array_size, q, 2, drop_head, NULL);
             }
-            show_queue(fifo, array_size);
+            show_queue(fifo, array_size, q);
         }
         if (status == 1) {
             puts("OVERFLOW!"); 
@@ -277,16 +919,16 @@ int main() {
         while ((status == 0) && (iterations < 1000)) {
             iterations++;
             if (rand() % 100 < 49) {
-                status = enqueue(fifo, array_size, p_head, p_tail, "ab");
+                status = enqueue(fifo, array_size, q, "ab");
             }
             if (rand() % 100 < 52) {
-                departure = dequeue(fifo, array_size, p_head, p_tail);
+                departure = dequeue(fifo, array_size, q);
             }
             // truncate every 10 steps to 2 elements in  queue
             if (iterations % 10 == 0) {
-                check_and_truncate(fifo, array_size, p_head, 2);
+                check_and_truncate(fifo, array_size, q, 2, drop_head, NULL);
             }
-            show_queue(fifo, array_size);
+            show_queue(fifo, array_size, q);
         }
         if (status == 1) {
             puts("OVERFLOW!"); 
@@ -303,16 +945,16 @@ int main() {
         while ((status == 0) && (iterations < 10000)) {
             iterations++;
             if (rand() % 100 < 25) {
-                status = enqueue(fifo, array_size, p_head, p_tail, "ab");
+                status = enqueue(fifo, array_size, q, "ab");
             }
             if (rand() % 100 < 30) {
-                departure = dequeue(fifo, array_size, p_head, p_tail);
+                departure = dequeue(fifo, array_size, q);
             }
             // truncate every 10 steps to 2 elements in  queue
             // if (iterations % 10 == 0) {
-            //     check_and_truncate(fifo, array_size, p_head, 2);
+            //     check_and_truncate(fifo, array_size, q, 2, drop_head, NULL);
             // }
-            show_queue(fifo, array_size);
+            show_queue(fifo, array_size, q);
         }
         if (status == 1) {
             puts("OVERFLOW!"); 
@@ -329,21 +971,250 @@ int main() {
         while ((status == 0) && (iterations < 10000)) {
             iterations++;
             if (rand() % 100 < 25) {
-                status = enqueue(fifo, array_size, p_head, p_tail, "ab");
+                status = enqueue(fifo, array_size, q, "ab");
             }
             if (rand() % 100 < 30) {
-                departure = dequeue(fifo, array_size, p_head, p_tail);
+                departure = dequeue(fifo, array_size, q);
             }
             // truncate every 10 steps to 2 elements in  queue
             if (iterations % 10 == 0) {
-                check_and_truncate(fifo, array_size, p_head, 2);
+                check_and_truncate(fifo, array_size, q, 2, drop_head, NULL);
             }
-            show_queue(fifo, array_size);
+            show_queue(fifo, array_size, q);
         }
         if (status == 1) {
             puts("OVERFLOW!"); 
         }
         break;        
+    /* 
+     * Example 11
+     * Enqueueing with probability 0.25
+     * Dequeueing with probability 0.30
+     * With control, dropping from tail
+     */
+    case 11:
+        srand(1234);
+        q->stamps = stamps;
+        while ((status == 0) && (iterations < 10000)) {
+            iterations++;
+            q->now = iterations;
+            if (rand() % 100 < 25) {
+                status = enqueue(fifo, array_size, q, "ab");
+            }
+            if (rand() % 100 < 30) {
+                age = q->now - stamps[q->head];
+                departure = dequeue(fifo, array_size, q);
+                if (departure) {
+                    departures++;
+                    sojourn += age;
+                }
+            }
+            // truncate every 10 steps to 2 elements in queue
+            if (iterations % 10 == 0) {
+                check_and_truncate(fifo, array_size, q, 2, drop_tail, &sink);
+            }
+            show_queue(fifo, array_size, q);
+        }
+        if (status == 1) {
+            puts("OVERFLOW!"); 
+        }
+        print_summary(departures, sink.dropped, sojourn);
+        printf("dropped bytes: %li\n", sink.bytes);
+        break;        
+    /* 
+     * Example 12
+     * Enqueueing with probability 0.25
+     * Dequeueing with probability 0.30
+     * With control, dropping at random
+     */
+    case 12:
+        srand(1234);
+        q->stamps = stamps;
+        while ((status == 0) && (iterations < 10000)) {
+            iterations++;
+            q->now = iterations;
+            if (rand() % 100 < 25) {
+                status = enqueue(fifo, array_size, q, "ab");
+            }
+            if (rand() % 100 < 30) {
+                age = q->now - stamps[q->head];
+                departure = dequeue(fifo, array_size, q);
+                if (departure) {
+                    departures++;
+                    sojourn += age;
+                }
+            }
+            // truncate every 10 steps to 2 random elements in queue
+            if (iterations % 10 == 0) {
+                check_and_truncate(fifo, array_size, q, 2, drop_random, &sink);
+            }
+            show_queue(fifo, array_size, q);
+        }
+        if (status == 1) {
+            puts("OVERFLOW!"); 
+        }
+        print_summary(departures, sink.dropped, sojourn);
+        printf("dropped bytes: %li\n", sink.bytes);
+        break;        
+    /* 
+     * Example 13
+     * Enqueueing with probability 0.25
+     * Dequeueing with probability 0.30
+     * With control, dropping by age
+     */
+    case 13:
+        srand(1234);
+        q->stamps = stamps;
+        while ((status == 0) && (iterations < 10000)) {
+            iterations++;
+            q->now = iterations;
+            if (rand() % 100 < 25) {
+                status = enqueue(fifo, array_size, q, "ab");
+            }
+            if (rand() % 100 < 30) {
+                age = q->now - stamps[q->head];
+                departure = dequeue(fifo, array_size, q);
+                if (departure) {
+                    departures++;
+                    sojourn += age;
+                }
+            }
+            // drop every 10 steps elements older than 8 steps
+            if (iterations % 10 == 0) {
+                check_and_truncate(fifo, array_size, q, 8, drop_by_age, &sink);
+            }
+            show_queue(fifo, array_size, q);
+        }
+        if (status == 1) {
+            puts("OVERFLOW!"); 
+        }
+        print_summary(departures, sink.dropped, sojourn);
+        printf("dropped bytes: %li\n", sink.bytes);
+        break;        
+    /* 
+     * Example 14
+     * Enqueueing with probability 0.25
+     * Dequeueing with probability 0.30
+     * With CoDel control (dropping at dequeue time)
+     */
+    case 14:
+        srand(1234);
+        q->stamps = stamps;
+        while ((status == 0) && (iterations < 10000)) {
+            iterations++;
+            q->now = iterations;
+            if (rand() % 100 < 25) {
+                status = enqueue(fifo, array_size, q, "ab");
+            }
+            if (rand() % 100 < 30) {
+                departure = codel_dequeue(fifo, array_size, q, &codel);
+                if (departure) {
+                    departures++;
+                    sojourn += codel.sojourn;
+                }
+            }
+            show_queue(fifo, array_size, q);
+        }
+        if (status == 1) {
+            puts("OVERFLOW!"); 
+        }
+        print_summary(departures, codel.dropped, sojourn);
+        break;        
+    /* 
+     * Example 15
+     * Enqueueing with probability 0.25
+     * Dequeueing with probability 0.30
+     * With RED admission (rejecting at enqueue time)
+     */
+    case 15:
+        srand(1234);
+        q->stamps = stamps;
+        while ((status == 0) && (iterations < 10000)) {
+            iterations++;
+            q->now = iterations;
+            if (rand() % 100 < 25) {
+                status = red_enqueue(fifo, array_size, q, &red, "ab");
+            }
+            if (rand() % 100 < 30) {
+                age = q->now - stamps[q->head];
+                departure = dequeue(fifo, array_size, q);
+                if (departure) {
+                    departures++;
+                    sojourn += age;
+                }
+            }
+            show_queue(fifo, array_size, q);
+        }
+        if (status == 1) {
+            puts("OVERFLOW!"); 
+        }
+        print_summary(departures, red.rejected, sojourn);
+        break;        
+    /* 
+     * Example 16
+     * Enqueueing with probability 0.25
+     * Dequeueing with probability 0.30
+     * With control, tracking queue length only (birth-death process): 
+     * no array, no strings, one million steps
+     */
+    case 16:
+        srand(1234);
+        while ((status == 0) && (iterations < 1000000)) {
+            iterations++;
+            arrival = rand() % 100 < 25;
+            attempt = rand() % 100 < 30;
+            status = length_step(&length, array_size, arrival, attempt);
+            // truncate every 10 steps to 2 elements in queue
+            if (iterations % 10 == 0) {
+                length_truncate(&length, 2);
+            }
+            hist[length.length]++;
+        }
+        if (status == 1) {
+            puts("OVERFLOW!"); 
+        }
+        print_length_stats(hist, array_size, iterations, length.dropped);
+        break;        
+    /* 
+     * Example 17
+     * Cross-check of queue length only against array, with the same 
+     * probabilities and control as example 10: both paths get the same 
+     * arrivals and departures and must give the same queue length in each 
+     * step and the same number of drops
+     */
+    case 17:
+        srand(1234);
+        while (iterations < 100000) {
+            iterations++;
+            arrival = rand() % 100 < 25;
+            attempt = rand() % 100 < 30;
+            status = 0;
+            if (arrival) {
+                status = enqueue(fifo, array_size, q, "ab");
+            }
+            if (attempt) {
+                departure = dequeue(fifo, array_size, q);
+            }
+            // explicit check, not assert: must also run with NDEBUG
+            int length_status = length_step(&length, array_size, arrival, 
+                                            attempt);
+            // truncate every 10 steps to 2 elements in queue
+            if (iterations % 10 == 0) {
+                dropped += check_and_truncate(fifo, array_size, q, 2, 
+                                              drop_head, NULL);
+                length_truncate(&length, 2);
+            }
+            if (length_status != status || length.length != q->count || 
+                length.dropped != dropped) {
+                printf("cross-check failed in step %i: queue length %i "
+                       "(array %i), dropped %i (array %i)\n", iterations, 
+                       length.length, q->count, length.dropped, dropped);
+                exit(1);
+            }
+        }
+        printf("cross-check passed: %i steps, queue length %i, dropped %i\n",
+               iterations, length.length, length.dropped);
+        break;        
     }
 
 }
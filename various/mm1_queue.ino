@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <Arduino.h>
 #include <LedControl.h>
 
@@ -43,7 +44,11 @@ const int DELAY = 10;
  * (see also README and functions and comments below)
  */
 
+// ARRAY_SIZE must be a power of two: indices are advanced by masking
+// with (size - 1), avoiding a slow integer division on AVR
 const int ARRAY_SIZE = 64;
+static_assert(ARRAY_SIZE > 0 && (ARRAY_SIZE & (ARRAY_SIZE - 1)) == 0,
+              "ARRAY_SIZE must be a power of two");
 char *fifo[] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
 NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
 NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
@@ -52,10 +57,19 @@ NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
 NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
 NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
 NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
-int head = 0;
-int tail = 0;
-int *p_head = &head;
-int *p_tail = &tail;
+static_assert(sizeof(fifo) / sizeof(fifo[0]) == ARRAY_SIZE,
+              "fifo must have ARRAY_SIZE slots");
+// head:  index of head
+// tail:  index of tail
+// count: number of elements in queue (queue length),
+//        maintained by enqueue and dequeue
+struct queue_state {
+	int head;
+	int tail;
+	int count;
+};
+struct queue_state state = { 0, 0, 0 };
+struct queue_state *p_state = &state;
 int iterations = 0;
 int queue_length = 0;
 
@@ -77,19 +91,24 @@ char *departure = NULL;
  *
  * parameters:
  *   fifo:    array of strings (char pointers)
- *   size:    size of array
- *   p_tail:  pointer to index of tail
+ *   size:    size of array (power of two)
+ *   q:       pointer to queue state
  *   arrival: string (char pointer) to be enqueued
  *
  * return value:
  *   0: no error
  *   1: overflow
  */
-int enqueue(char *fifo[], int size, int *p_tail, char *arrival) {
-	fifo[*p_tail] = arrival;
-	*p_tail = (*p_tail + 1) % size;
+int enqueue(char *fifo[], int size, struct queue_state *q, char *arrival) {
+	// no free slot left - arrival is lost
+	if (q->count == size) {
+		return 1;
+	}
+	fifo[q->tail] = arrival;
+	q->tail = (q->tail + 1) & (size - 1);
+	q->count++;
 	// next slot must be empty, otherwise overflow
-	if (!fifo[*p_tail]) {
+	if (q->count < size) {
 		return 0;
 	} else {
 		return 1;
@@ -102,21 +121,20 @@ int enqueue(char *fifo[], int size, int *p_tail, char *arrival) {
  *
  * parameters:
  *   fifo:    array of strings (char pointers)
- *   size:    size of array
- *   p_head:  pointer to index of head
- *   p_tail:  pointer to index of tail
+ *   size:    size of array (power of two)
+ *   q:       pointer to queue state
  *
  * return value:
  *   dequeued string (char pointer)
  *   NULL if queue was empty
  */
-char* dequeue(char *fifo[], int size, int *p_head, int *p_tail) {
-	char *departure = fifo[*p_head];
-	if (departure) {
-		fifo[*p_head] = NULL;
-		if (*p_head != *p_tail) {
-			*p_head = (*p_head + 1) % size;
-		}
+char* dequeue(char *fifo[], int size, struct queue_state *q) {
+	char *departure = NULL;
+	if (q->count > 0) {
+		departure = fifo[q->head];
+		fifo[q->head] = NULL;
+		q->head = (q->head + 1) & (size - 1);
+		q->count--;
 	}
 	return departure;
 }
@@ -125,40 +143,40 @@ char* dequeue(char *fifo[], int size, int *p_head, int *p_tail) {
  * function get_queue_length
  *
  * parameters:
- *   fifo:       array of strings (char pointers)
- *   array_size: size of array
+ *   q:       pointer to queue state
  *
  * return value:
  *   queue length
  */
-int get_queue_length(char *fifo[], int array_size) {
-	int queue_length = 0;
-	for (int i = 0; i < array_size; i++) {
-		if (fifo[i]) {
-			queue_length++;
-		}
-	}
-	return queue_length;
+int get_queue_length(struct queue_state *q) {
+	return q->count;
 }
 
 /*
  * function check_and_truncate
  *   if queue length exceeds the limit, truncate to this limit
- *   (current implementation: truncate starting from head of queue)
+ *   (current implementation: truncate starting from head of queue,
+ *   constant number of steps regardless of number of dropped elements)
  *
  * parameters:
  *   fifo:    array of strings (char pointers)
- *   size:    size of array
- *   p_head:  pointer to index of head
+ *   size:    size of array (power of two)
+ *   q:       pointer to queue state
  *   limit:   desired limit of queue length
  */
-void check_and_truncate(char *fifo[], int size, int *p_head, int limit) {
-	int queue_length = get_queue_length(fifo, size);
-	while (fifo[*p_head] && (queue_length > limit)) {
-		fifo[*p_head] = NULL;
-		*p_head = (*p_head + 1) % size;
-		queue_length--;
+void check_and_truncate(char *fifo[], int size, struct queue_state *q,
+		int limit) {
+	if (q->count <= limit) {
+		return;
 	}
+	// drop excess elements in one step, set dropped slots to NULL
+	// (at most two segments around end of array)
+	int excess = q->count - limit;
+	int n = size - q->head < excess ? size - q->head : excess;
+	memset(fifo + q->head, 0, n * sizeof(char *));
+	memset(fifo, 0, (excess - n) * sizeof(char *));
+	q->head = (q->head + excess) & (size - 1);
+	q->count = limit;
 }
 
 /*
@@ -197,19 +215,19 @@ void loop() {
 		iterations++;
 		// enqueueing with probability ARRIVAL_PROB
 		if (rand() % 100 < ARRIVAL_PROB) {
-			system_status = enqueue(fifo, ARRAY_SIZE, p_tail, arrival);
+			system_status = enqueue(fifo, ARRAY_SIZE, p_state, arrival);
 		}
 		// dequeueing with probability DEPARTURE_PROB
 		if (rand() % 100 < DEPARTURE_PROB) {
-			departure = dequeue(fifo, ARRAY_SIZE, p_head, p_tail);
+			departure = dequeue(fifo, ARRAY_SIZE, p_state);
 		}
 		// control: truncate every QUEUE_CONTROL_INTERVAL steps to
 		// QUEUE_CONTROL_LIMIT elements in queue
 		if ((CONTROL == 'Y') && (iterations % QUEUE_CONTROL_INTERVAL == 0)) {
-			check_and_truncate(fifo, ARRAY_SIZE, p_head, QUEUE_CONTROL_LIMIT);
+			check_and_truncate(fifo, ARRAY_SIZE, p_state, QUEUE_CONTROL_LIMIT);
 			iterations = 0;
 		}
-		queue_length = get_queue_length(fifo, ARRAY_SIZE);
+		queue_length = get_queue_length(p_state);
 		write_led_matrix(queue_length);
 	} else {
 		// overflow - stop simulation
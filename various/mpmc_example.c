@@ -0,0 +1,244 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+/*
+ * Bounded multi-producer/multi-consumer ring, e.g. several sensor ingest
+ * threads feeding one queue and several uplink workers draining it.
+ *
+ * Same layout as the power-of-two ring in ring_example.c, with a sequence
+ * number per slot (D. Vyukov's bounded MPMC queue) instead of a mutex:
+ * - slot i starts with sequence i
+ * - a producer may fill the slot of position p when its sequence is p;
+ *   after writing it stores sequence p + 1 (slot full)
+ * - a consumer may empty the slot of position p when its sequence is
+ *   p + 1; after reading it stores sequence p + capacity (slot free for
+ *   the producer one lap later)
+ * - producers claim positions by a CAS on tail, consumers by a CAS on
+ *   head - a single CAS per operation unless another thread won the race
+ */
+
+typedef uint32_t ring_pos;
+
+#define CACHE_LINE 64
+
+/*
+ * Struct mpmc_slot
+ *
+ * Members:
+ *   sequence: position the slot is ready for (see above)
+ *   element:  string (char pointer)
+ */
+struct mpmc_slot {
+    _Atomic ring_pos sequence;
+    char *element;
+};
+
+/*
+ * Struct mpmc_ring
+ *
+ * Members:
+ *   head:    position of element that will be dequeued next
+ *   tail:    position of slot where next element will be enqueued
+ *   slots:   array of slots
+ *   mask:    capacity - 1 (capacity is a power of two)
+ */
+struct mpmc_ring {
+    alignas(CACHE_LINE) _Atomic ring_pos head;
+    alignas(CACHE_LINE) _Atomic ring_pos tail;
+    alignas(CACHE_LINE) struct mpmc_slot *slots;
+    ring_pos mask;
+};
+
+/*
+ * Function mpmc_init
+ *
+ * Parameters:
+ *   r:        pointer to ring
+ *   slots:    array of slots
+ *   capacity: size of array, must be a power of two and at least 2
+ *             (with one slot, sequence p + 1 would mean both full and
+ *             free)
+ *
+ * Return value:
+ *   0: no error
+ *   1: capacity is not a power of two or less than 2
+ */
+int mpmc_init(struct mpmc_ring *r, struct mpmc_slot slots[],
+              ring_pos capacity) {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        return 1;
+    }
+    for (ring_pos i = 0; i < capacity; i++) {
+        atomic_init(&slots[i].sequence, i);
+        slots[i].element = NULL;
+    }
+    r->slots = slots;
+    r->mask = capacity - 1;
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    return 0;
+}
+
+/*
+ * Function mpmc_enqueue
+ *   may be called by any number of threads
+ *
+ * Parameters:
+ *   r:       pointer to ring
+ *   arrival: string (char pointer) to be enqueued
+ *
+ * Return value:
+ *   0: no error
+ *   1: overflow (all slots occupied, arrival not enqueued)
+ */
+int mpmc_enqueue(struct mpmc_ring *r, char *arrival) {
+    ring_pos tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    for (;;) {
+        struct mpmc_slot *slot = &r->slots[tail & r->mask];
+        ring_pos sequence = atomic_load_explicit(&slot->sequence,
+                                                 memory_order_acquire);
+        int32_t diff = (int32_t) (sequence - tail);
+        if (diff == 0) {
+            // slot free - claim position (on failure tail is reloaded)
+            if (atomic_compare_exchange_weak_explicit(
+                    &r->tail, &tail, tail + 1,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                slot->element = arrival;
+                atomic_store_explicit(&slot->sequence, tail + 1,
+                                      memory_order_release);
+                return 0;
+            }
+        } else if (diff < 0) {
+            // slot still holds element of previous lap - full
+            return 1;
+        } else {
+            // another producer claimed this position
+            tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+        }
+    }
+}
+
+/*
+ * Function mpmc_dequeue
+ *   may be called by any number of threads
+ *
+ * Parameters:
+ *   r:       pointer to ring
+ *
+ * Return value:
+ *   dequeued string (char pointer)
+ *   NULL if queue was empty
+ */
+char* mpmc_dequeue(struct mpmc_ring *r) {
+    ring_pos head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    for (;;) {
+        struct mpmc_slot *slot = &r->slots[head & r->mask];
+        ring_pos sequence = atomic_load_explicit(&slot->sequence,
+                                                 memory_order_acquire);
+        int32_t diff = (int32_t) (sequence - (head + 1));
+        if (diff == 0) {
+            // slot full - claim position (on failure head is reloaded)
+            if (atomic_compare_exchange_weak_explicit(
+                    &r->head, &head, head + 1,
+                    memory_order_relaxed, memory_order_relaxed)) {
+                char *departure = slot->element;
+                atomic_store_explicit(&slot->sequence, head + r->mask + 1,
+                                      memory_order_release);
+                return departure;
+            }
+        } else if (diff < 0) {
+            // slot not yet filled - empty
+            return NULL;
+        } else {
+            // another consumer claimed this position
+            head = atomic_load_explicit(&r->head, memory_order_relaxed);
+        }
+    }
+}
+
+// Example: several ingest threads and several uplink workers
+
+#define CAPACITY 1024
+#define PRODUCERS 4
+#define CONSUMERS 4
+#define OPERATIONS_PER_PRODUCER 2000000L
+
+struct mpmc_slot slots[CAPACITY];
+struct mpmc_ring ring;
+// one record per producer, departures counted per record
+char records[PRODUCERS][3];
+_Atomic long departures[PRODUCERS];
+_Atomic long remaining = PRODUCERS * OPERATIONS_PER_PRODUCER;
+
+void* ingest(void *arg) {
+    char *record = arg;
+    for (long i = 0; i < OPERATIONS_PER_PRODUCER; i++) {
+        while (mpmc_enqueue(&ring, record) != 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+void* uplink(void *arg) {
+    (void) arg;
+    while (atomic_load(&remaining) > 0) {
+        char *departure = mpmc_dequeue(&ring);
+        if (departure) {
+            atomic_fetch_add(&departures[(departure - records[0]) / 3], 1);
+            atomic_fetch_sub(&remaining, 1);
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// Function main with example
+
+int main() {
+    pthread_t producers[PRODUCERS];
+    pthread_t consumers[CONSUMERS];
+    struct timespec start;
+    struct timespec end;
+
+    for (int i = 0; i < PRODUCERS; i++) {
+        records[i][0] = 'a' + i;
+        records[i][1] = 'b' + i;
+        records[i][2] = '\0';
+    }
+    mpmc_init(&ring, slots, CAPACITY);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < CONSUMERS; i++) {
+        pthread_create(&consumers[i], NULL, uplink, NULL);
+    }
+    for (int i = 0; i < PRODUCERS; i++) {
+        pthread_create(&producers[i], NULL, ingest, records[i]);
+    }
+    for (int i = 0; i < PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    for (int i = 0; i < CONSUMERS; i++) {
+        pthread_join(consumers[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    for (int i = 0; i < PRODUCERS; i++) {
+        printf("record %s departures: %li\n", records[i],
+               atomic_load(&departures[i]));
+    }
+    printf("queue empty: %s\n", mpmc_dequeue(&ring) ? "no" : "yes");
+    double seconds = (end.tv_sec - start.tv_sec) +
+                     (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("seconds: %.3f operations per second: %.0f\n", seconds,
+           PRODUCERS * OPERATIONS_PER_PRODUCER / seconds);
+
+    puts("\nEnd of program. \n");
+}
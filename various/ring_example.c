@@ -0,0 +1,420 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Positions of head and tail
+ *
+ * Positions increase monotonically and are never reduced modulo the
+ * capacity. The slot of a position is (position & mask). Unsigned
+ * arithmetic wraps around, so (tail - head) is the queue length even
+ * after the positions have overflowed. 32 bits are enough for any
+ * capacity up to 2^31 - use uint64_t if positions are exported as
+ * running counters.
+ */
+typedef uint32_t ring_pos;
+
+// largest capacity a growable ring doubles to (power of two)
+#define RING_MAX_CAPACITY ((ring_pos) 1 << 31)
+
+/*
+ * Struct ring
+ *
+ * Members:
+ *   slots:   array of strings (char pointers)
+ *   mask:    capacity - 1 (capacity is a power of two)
+ *   head:    position of element that will be dequeued next
+ *   tail:    position of slot where next element will be enqueued
+ *   growable:     1: slots allocated by ring, capacity doubled when full
+ *                 0: fixed capacity, overflow when full
+ *   max_capacity: hard cap on capacity of a growable ring
+ *                 (0: no cap up to RING_MAX_CAPACITY)
+ */
+struct ring {
+    char **slots;
+    ring_pos mask;
+    ring_pos head;
+    ring_pos tail;
+    int growable;
+    ring_pos max_capacity;
+};
+
+/*
+ * Function ring_init
+ *
+ * Parameters:
+ *   r:        pointer to ring
+ *   slots:    array of strings (char pointers)
+ *   capacity: size of array, must be a power of two
+ *
+ * Return value:
+ *   0: no error
+ *   1: capacity is not a power of two
+ */
+int ring_init(struct ring *r, char *slots[], ring_pos capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return 1;
+    }
+    r->slots = slots;
+    r->mask = capacity - 1;
+    r->head = 0;
+    r->tail = 0;
+    r->growable = 0;
+    r->max_capacity = 0;
+    for (ring_pos i = 0; i < capacity; i++) {
+        slots[i] = NULL;
+    }
+    return 0;
+}
+
+/*
+ * Function ring_init_growable
+ *   ring allocates its slots and doubles its capacity when full
+ *   (release memory with ring_free)
+ *
+ * Parameters:
+ *   r:            pointer to ring
+ *   capacity:     initial capacity, must be a power of two
+ *   max_capacity: hard cap on capacity (0: no cap)
+ *
+ * Return value:
+ *   0: no error
+ *   1: capacity is not a power of two or out of memory
+ */
+int ring_init_growable(struct ring *r, ring_pos capacity,
+                       ring_pos max_capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0 ||
+        capacity > RING_MAX_CAPACITY) {
+        return 1;
+    }
+    char **slots = calloc(capacity, sizeof(char *));
+    if (!slots) {
+        return 1;
+    }
+    r->slots = slots;
+    r->mask = capacity - 1;
+    r->head = 0;
+    r->tail = 0;
+    r->growable = 1;
+    r->max_capacity = max_capacity;
+    return 0;
+}
+
+/*
+ * Function ring_free
+ *   release slots of a growable ring
+ */
+void ring_free(struct ring *r) {
+    if (r->growable) {
+        free(r->slots);
+        r->slots = NULL;
+    }
+}
+
+/*
+ * Function ring_grow
+ *   double capacity of a growable ring, unwrapping the elements into
+ *   the new slots (at most two memcpy calls) - head is moved to
+ *   position 0
+ *
+ * Parameters:
+ *   r:       pointer to ring
+ *
+ * Return value:
+ *   0: no error
+ *   1: fixed ring, cap reached or out of memory
+ */
+int ring_grow(struct ring *r) {
+    ring_pos capacity = r->mask + 1;
+    ring_pos cap = r->max_capacity ? r->max_capacity : RING_MAX_CAPACITY;
+    if (!r->growable || capacity > cap / 2) {
+        return 1;
+    }
+    char **slots = calloc(2 * (size_t) capacity, sizeof(char *));
+    if (!slots) {
+        return 1;
+    }
+    ring_pos length = r->tail - r->head;
+    ring_pos first = r->head & r->mask;
+    // elements from head to end of array, then wrapped part
+    ring_pos n = capacity - first < length ? capacity - first : length;
+    memcpy(slots, r->slots + first, n * sizeof(char *));
+    memcpy(slots + n, r->slots, (length - n) * sizeof(char *));
+    free(r->slots);
+    r->slots = slots;
+    r->mask = 2 * capacity - 1;
+    r->head = 0;
+    r->tail = length;
+    return 0;
+}
+
+/*
+ * Function ring_length
+ *
+ * Return value:
+ *   number of elements in ring (queue length)
+ */
+ring_pos ring_length(const struct ring *r) {
+    return r->tail - r->head;
+}
+
+/*
+ * Function ring_enqueue
+ *
+ * Parameters:
+ *   r:       pointer to ring
+ *   arrival: string (char pointer) to be enqueued
+ *
+ * Return value:
+ *   0: no error
+ *   1: overflow (all slots occupied, arrival not enqueued) - a growable
+ *      ring only overflows when its cap is reached
+ */
+int ring_enqueue(struct ring *r, char *arrival) {
+    if (r->tail - r->head > r->mask && ring_grow(r) != 0) {
+        return 1;
+    }
+    r->slots[r->tail & r->mask] = arrival;
+    r->tail++;
+    return 0;
+}
+
+/*
+ * Function ring_dequeue
+ *
+ * Parameters:
+ *   r:       pointer to ring
+ *
+ * Return value:
+ *   dequeued string (char pointer)
+ *   NULL if queue was empty
+ */
+char* ring_dequeue(struct ring *r) {
+    if (r->tail == r->head) {
+        return NULL;
+    }
+    char *departure = r->slots[r->head & r->mask];
+    r->slots[r->head & r->mask] = NULL;
+    r->head++;
+    return departure;
+}
+
+/*
+ * Function ring_enqueue_n
+ *   enqueue up to n elements at once, copied into the slots in at most
+ *   two contiguous segments around the end of the array - tail is
+ *   updated once per batch
+ *
+ * Parameters:
+ *   r:        pointer to ring
+ *   arrivals: array of strings (char pointers) to be enqueued
+ *   n:        number of elements in arrivals
+ *
+ * Return value:
+ *   number of elements enqueued (less than n: overflow)
+ */
+ring_pos ring_enqueue_n(struct ring *r, char *arrivals[], ring_pos n) {
+    // growable ring: double until batch fits (or cap reached)
+    while (r->mask + 1 - (r->tail - r->head) < n) {
+        if (ring_grow(r) != 0) {
+            break;
+        }
+    }
+    ring_pos capacity = r->mask + 1;
+    ring_pos free_slots = capacity - (r->tail - r->head);
+    if (n > free_slots) {
+        n = free_slots;
+    }
+    ring_pos first = r->tail & r->mask;
+    ring_pos k = capacity - first < n ? capacity - first : n;
+    memcpy(r->slots + first, arrivals, k * sizeof(char *));
+    memcpy(r->slots, arrivals + k, (n - k) * sizeof(char *));
+    r->tail += n;
+    return n;
+}
+
+/*
+ * Function ring_dequeue_n
+ *   dequeue up to n elements at once, copied out of the slots in at most
+ *   two contiguous segments around the end of the array - head is
+ *   updated once per batch
+ *
+ * Parameters:
+ *   r:          pointer to ring
+ *   departures: array receiving the dequeued strings (char pointers)
+ *   n:          size of departures
+ *
+ * Return value:
+ *   number of elements dequeued (0 if queue was empty)
+ */
+ring_pos ring_dequeue_n(struct ring *r, char *departures[], ring_pos n) {
+    ring_pos capacity = r->mask + 1;
+    if (n > r->tail - r->head) {
+        n = r->tail - r->head;
+    }
+    ring_pos first = r->head & r->mask;
+    ring_pos k = capacity - first < n ? capacity - first : n;
+    memcpy(departures, r->slots + first, k * sizeof(char *));
+    memcpy(departures + k, r->slots, (n - k) * sizeof(char *));
+    memset(r->slots + first, 0, k * sizeof(char *));
+    memset(r->slots, 0, (n - k) * sizeof(char *));
+    r->head += n;
+    return n;
+}
+
+// Helper functions for messages
+
+void check_status(int status) {
+    if (status == 0) {
+        puts("ok");
+    } else {
+        puts("overflow");
+    }
+}
+
+void check_departure(char *departure) {
+    if (departure) {
+        printf("departure %s\n", departure);
+    } else {
+        puts("no departure");
+    }
+}
+
+void print_ring(const struct ring *r) {
+    printf("\nRing (head: %u tail: %u length: %u):\n",
+           (unsigned) r->head, (unsigned) r->tail,
+           (unsigned) ring_length(r));
+    for (ring_pos i = 0; i <= r->mask; i++) {
+        if (r->slots[i]) {
+            printf("  %s\n", r->slots[i]);
+        } else {
+            printf("  element %u is empty\n", (unsigned) i);
+        }
+    }
+}
+
+// Function main with example
+
+int main() {
+    char *slots[4];
+    struct ring ring;
+    struct ring *r = &ring;
+    char *departure;
+
+    char *not_power_of_two[3];
+    if (ring_init(r, not_power_of_two, 3) != 0) {
+        puts("capacity 3 rejected, not a power of two");
+    }
+
+    ring_init(r, slots, 4);
+    // start close to the largest position to show that the
+    // positions may overflow
+    r->head = UINT32_MAX - 2;
+    r->tail = UINT32_MAX - 2;
+    print_ring(r);
+
+    departure = ring_dequeue(r);
+    check_departure(departure);
+
+    check_status(ring_enqueue(r, "ab"));
+    check_status(ring_enqueue(r, "cd"));
+    check_status(ring_enqueue(r, "ef"));
+    print_ring(r);
+
+    departure = ring_dequeue(r);
+    check_departure(departure);
+
+    check_status(ring_enqueue(r, "gh"));
+    check_status(ring_enqueue(r, "ij"));
+    check_status(ring_enqueue(r, "kl"));
+    print_ring(r);
+
+    while ((departure = ring_dequeue(r))) {
+        check_departure(departure);
+    }
+    check_departure(departure);
+    print_ring(r);
+
+    /*
+     * Batches, wrapping around the end of the array
+     */
+    char *arrivals[] = {"mn", "op", "qr", "st", "uv"};
+    char *departures[4];
+    ring_pos n;
+    printf("\nenqueued: %u\n", (unsigned) ring_enqueue_n(r, arrivals, 3));
+    n = ring_dequeue_n(r, departures, 2);
+    printf("dequeued: %u\n", (unsigned) n);
+    printf("enqueued: %u\n", (unsigned) ring_enqueue_n(r, arrivals, 5));
+    print_ring(r);
+    n = ring_dequeue_n(r, departures, 4);
+    for (ring_pos i = 0; i < n; i++) {
+        check_departure(departures[i]);
+    }
+    print_ring(r);
+
+    /*
+     * Growable ring, starting with 2 slots
+     */
+    ring_init_growable(r, 2, 0);
+    check_status(ring_enqueue(r, "ab"));
+    check_status(ring_enqueue(r, "cd"));
+    departure = ring_dequeue(r);
+    check_departure(departure);
+    check_status(ring_enqueue(r, "ef"));
+    // full and wrapped around - doubled to 4 slots
+    check_status(ring_enqueue(r, "gh"));
+    print_ring(r);
+    ring_free(r);
+
+    /*
+     * Growable ring under near-critical load, without control
+     * Enqueueing with probability 0.49
+     * Dequeueing with probability 0.52
+     */
+    int status = 0;
+    int iterations = 0;
+    ring_pos max_length = 0;
+    ring_init_growable(r, 16, 0);
+    srand(1234);
+    while ((status == 0) && (iterations < 1000000)) {
+        iterations++;
+        if (rand() % 100 < 49) {
+            status = ring_enqueue(r, "ab");
+        }
+        if (rand() % 100 < 52) {
+            ring_dequeue(r);
+        }
+        if (ring_length(r) > max_length) {
+            max_length = ring_length(r);
+        }
+    }
+    printf("\niterations: %i max length: %u capacity: %u\n", iterations,
+           (unsigned) max_length, (unsigned) (r->mask + 1));
+    check_status(status);
+    ring_free(r);
+
+    /*
+     * Growable ring with hard cap of 16 slots
+     * Enqueueing with probability 0.4
+     * Dequeueing with probability 0.2
+     */
+    status = 0;
+    iterations = 0;
+    ring_init_growable(r, 2, 16);
+    while ((status == 0) && (iterations < 1000)) {
+        iterations++;
+        if (rand() % 100 < 40) {
+            status = ring_enqueue(r, "ab");
+        }
+        if (rand() % 100 < 20) {
+            ring_dequeue(r);
+        }
+    }
+    printf("\niterations: %i length: %u capacity: %u\n", iterations,
+           (unsigned) ring_length(r), (unsigned) (r->mask + 1));
+    check_status(status);
+    ring_free(r);
+
+    puts("\nEnd of program. \n");
+}
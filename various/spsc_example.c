@@ -0,0 +1,311 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdalign.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+/*
+ * Single-producer/single-consumer ring for two threads, e.g. one thread
+ * ingesting records (get_next_arrival in lora_03.ino) and one thread
+ * transmitting them (transmit/transmission_status_and_cleanup).
+ *
+ * Same layout as the power-of-two ring in ring_example.c: head and tail
+ * are monotonically increasing positions, masked to get slot indices.
+ * Only the producer writes tail and only the consumer writes head, so no
+ * locks are needed:
+ * - a slot is published by storing tail with release semantics after
+ *   writing the slot, and read by loading tail with acquire semantics
+ *   before reading the slot (and vice versa for head and freed slots)
+ * - head and tail are placed on separate cache lines, so producer and
+ *   consumer do not invalidate each other's line on every operation
+ * - each side keeps a cached copy of the opposite index and only reloads
+ *   the shared one when the cached copy says full (producer) or empty
+ *   (consumer)
+ */
+
+typedef uint32_t ring_pos;
+
+#define CACHE_LINE 64
+
+/*
+ * Struct spsc_ring
+ *
+ * Members:
+ *   head:        position of element that will be dequeued next
+ *                (written by consumer)
+ *   cached_tail: consumer's copy of tail
+ *   tail:        position of slot where next element will be enqueued
+ *                (written by producer)
+ *   cached_head: producer's copy of head
+ *   slots:       array of strings (char pointers)
+ *   mask:        capacity - 1 (capacity is a power of two)
+ */
+struct spsc_ring {
+    alignas(CACHE_LINE) _Atomic ring_pos head;
+    ring_pos cached_tail;
+    alignas(CACHE_LINE) _Atomic ring_pos tail;
+    ring_pos cached_head;
+    alignas(CACHE_LINE) char **slots;
+    ring_pos mask;
+};
+
+/*
+ * Function spsc_init
+ *
+ * Parameters:
+ *   r:        pointer to ring
+ *   slots:    array of strings (char pointers)
+ *   capacity: size of array, must be a power of two
+ *
+ * Return value:
+ *   0: no error
+ *   1: capacity is not a power of two
+ */
+int spsc_init(struct spsc_ring *r, char *slots[], ring_pos capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return 1;
+    }
+    r->slots = slots;
+    r->mask = capacity - 1;
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    r->cached_head = 0;
+    r->cached_tail = 0;
+    return 0;
+}
+
+/*
+ * Function spsc_enqueue
+ *   to be called by the producer thread only
+ *
+ * Parameters:
+ *   r:       pointer to ring
+ *   arrival: string (char pointer) to be enqueued
+ *
+ * Return value:
+ *   0: no error
+ *   1: overflow (all slots occupied, arrival not enqueued)
+ */
+int spsc_enqueue(struct spsc_ring *r, char *arrival) {
+    ring_pos tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (tail - r->cached_head > r->mask) {
+        r->cached_head = atomic_load_explicit(&r->head,
+                                              memory_order_acquire);
+        if (tail - r->cached_head > r->mask) {
+            return 1;
+        }
+    }
+    r->slots[tail & r->mask] = arrival;
+    atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+    return 0;
+}
+
+/*
+ * Function spsc_dequeue
+ *   to be called by the consumer thread only
+ *
+ * Parameters:
+ *   r:       pointer to ring
+ *
+ * Return value:
+ *   dequeued string (char pointer)
+ *   NULL if queue was empty
+ */
+char* spsc_dequeue(struct spsc_ring *r) {
+    ring_pos head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    if (head == r->cached_tail) {
+        r->cached_tail = atomic_load_explicit(&r->tail,
+                                              memory_order_acquire);
+        if (head == r->cached_tail) {
+            return NULL;
+        }
+    }
+    char *departure = r->slots[head & r->mask];
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+    return departure;
+}
+
+/*
+ * Function spsc_enqueue_n
+ *   to be called by the producer thread only
+ *   enqueue up to n elements at once, copied into the slots in at most
+ *   two contiguous segments around the end of the array - tail is
+ *   published once per batch
+ *
+ * Parameters:
+ *   r:        pointer to ring
+ *   arrivals: array of strings (char pointers) to be enqueued
+ *   n:        number of elements in arrivals
+ *
+ * Return value:
+ *   number of elements enqueued (less than n: overflow)
+ */
+ring_pos spsc_enqueue_n(struct spsc_ring *r, char *arrivals[], ring_pos n) {
+    ring_pos capacity = r->mask + 1;
+    ring_pos tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (capacity - (tail - r->cached_head) < n) {
+        r->cached_head = atomic_load_explicit(&r->head,
+                                              memory_order_acquire);
+        if (capacity - (tail - r->cached_head) < n) {
+            n = capacity - (tail - r->cached_head);
+        }
+    }
+    ring_pos first = tail & r->mask;
+    ring_pos k = capacity - first < n ? capacity - first : n;
+    memcpy(r->slots + first, arrivals, k * sizeof(char *));
+    memcpy(r->slots, arrivals + k, (n - k) * sizeof(char *));
+    atomic_store_explicit(&r->tail, tail + n, memory_order_release);
+    return n;
+}
+
+/*
+ * Function spsc_dequeue_n
+ *   to be called by the consumer thread only
+ *   dequeue up to n elements at once, copied out of the slots in at most
+ *   two contiguous segments around the end of the array - head is
+ *   published once per batch
+ *
+ * Parameters:
+ *   r:          pointer to ring
+ *   departures: array receiving the dequeued strings (char pointers)
+ *   n:          size of departures
+ *
+ * Return value:
+ *   number of elements dequeued (0 if queue was empty)
+ */
+ring_pos spsc_dequeue_n(struct spsc_ring *r, char *departures[],
+                        ring_pos n) {
+    ring_pos capacity = r->mask + 1;
+    ring_pos head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    if (r->cached_tail - head < n) {
+        r->cached_tail = atomic_load_explicit(&r->tail,
+                                              memory_order_acquire);
+        if (r->cached_tail - head < n) {
+            n = r->cached_tail - head;
+        }
+    }
+    ring_pos first = head & r->mask;
+    ring_pos k = capacity - first < n ? capacity - first : n;
+    memcpy(departures, r->slots + first, k * sizeof(char *));
+    memcpy(departures + k, r->slots, (n - k) * sizeof(char *));
+    atomic_store_explicit(&r->head, head + n, memory_order_release);
+    return n;
+}
+
+/*
+ * Function spsc_length
+ *   snapshot of queue length, exact only if neither thread is active
+ */
+ring_pos spsc_length(struct spsc_ring *r) {
+    return atomic_load_explicit(&r->tail, memory_order_acquire) -
+           atomic_load_explicit(&r->head, memory_order_acquire);
+}
+
+// Example: ingest thread and transmit thread
+
+#define CAPACITY 1024
+#define RECORDS 16
+#define OPERATIONS 20000000L
+// elements per call of spsc_enqueue_n/spsc_dequeue_n
+// (1: spsc_enqueue/spsc_dequeue)
+#define BATCH 256
+
+char *slots[CAPACITY];
+struct spsc_ring ring;
+char records[RECORDS][3];
+
+int batch = 1;
+
+void* ingest(void *arg) {
+    struct spsc_ring *r = arg;
+    char *arrivals[BATCH];
+    long i = 0;
+    while (i < OPERATIONS) {
+        // records enqueued in a fixed rotation, checked by consumer
+        if (batch == 1) {
+            while (spsc_enqueue(r, records[i % RECORDS]) != 0) {
+                sched_yield();
+            }
+            i++;
+            continue;
+        }
+        ring_pos n = OPERATIONS - i < batch ? OPERATIONS - i : batch;
+        for (ring_pos j = 0; j < n; j++) {
+            arrivals[j] = records[(i + j) % RECORDS];
+        }
+        ring_pos done = 0;
+        while ((done += spsc_enqueue_n(r, arrivals + done, n - done)) < n) {
+            sched_yield();
+        }
+        i += n;
+    }
+    return NULL;
+}
+
+void* transmit(void *arg) {
+    struct spsc_ring *r = arg;
+    char *departures[BATCH];
+    long errors = 0;
+    long i = 0;
+    while (i < OPERATIONS) {
+        ring_pos n;
+        if (batch == 1) {
+            while (!(departures[0] = spsc_dequeue(r))) {
+                sched_yield();
+            }
+            n = 1;
+        } else {
+            while ((n = spsc_dequeue_n(r, departures, batch)) == 0) {
+                sched_yield();
+            }
+        }
+        for (ring_pos j = 0; j < n; j++, i++) {
+            if (departures[j] != records[i % RECORDS]) {
+                errors++;
+            }
+        }
+    }
+    return (void *) errors;
+}
+
+// Function main with example
+
+int main() {
+    struct spsc_ring *r = &ring;
+    pthread_t producer;
+    pthread_t consumer;
+    void *errors;
+    struct timespec start;
+    struct timespec end;
+
+    for (int i = 0; i < RECORDS; i++) {
+        records[i][0] = 'a' + i;
+        records[i][1] = 'b' + i;
+        records[i][2] = '\0';
+    }
+
+    // single elements, then batches
+    for (batch = 1; batch <= BATCH; batch *= BATCH) {
+        spsc_init(r, slots, CAPACITY);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        pthread_create(&consumer, NULL, transmit, r);
+        pthread_create(&producer, NULL, ingest, r);
+        pthread_join(producer, NULL);
+        pthread_join(consumer, &errors);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        double seconds = (end.tv_sec - start.tv_sec) +
+                         (end.tv_nsec - start.tv_nsec) / 1e9;
+        printf("batch: %i operations: %li errors: %li length: %u\n", batch,
+               OPERATIONS, (long) errors, (unsigned) spsc_length(r));
+        printf("seconds: %.3f operations per second: %.0f\n", seconds,
+               OPERATIONS / seconds);
+    }
+
+    puts("\nEnd of program. \n");
+}